@@ -0,0 +1,186 @@
+/*
+ *      Filename: admission.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Online admission control for fixed priority periodic tasks
+//
+// A new periodic task is only started if the task set stays schedulable by
+// exact response time analysis (RTA):
+//
+//      R_i = C_i + sum over j in hp(i) of ceil(R_i / T_j) * C_j,   R_i <= D_i
+//
+// where hp(i) are the tasks with a higher or equal priority (equal priorities
+// share the processor round robin, so they interfere with each other).
+//
+// The analysis is incremental. Tasks above the new one keep their response
+// times. Every iteration is seeded with a lower bound of the new fixed point, so
+// it converges to the same least solution in a few steps instead of starting
+// from C_i:
+//   - new task k:             R_k >= R_j + C_k, j the nearest strictly higher priority task
+//   - lower priority task i:  R_i' >= R_i + C_k, R_i its response time without task k
+//
+// Tasks listed in the table are sorted by priority, highest first. Entries of
+// tasks that have stopped are dropped and the rest is then analysed from scratch.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "admission.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+ADMITTED_TASK admitted[MAX_ADMITTED];
+uint8_t admittedCount = 0;
+
+// analysis result of the last successful admissionTest(), kept for admissionCommit()
+static ADMITTED_TASK candidate[MAX_ADMITTED];
+static uint8_t candidateCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: responseTime()
+* iterates the RTA equation for task i of set[] from the seed
+* returns the response time, or 0 if it exceeds the deadline
+*/
+static uint32_t responseTime(ADMITTED_TASK set[], uint8_t count, uint8_t i, uint32_t seed)
+{
+    uint32_t r = seed, next;
+    uint8_t j;
+
+    while (1)
+    {
+        next = set[i].wcet;
+        for (j = 0; j < count; j++)
+            if (j != i && set[j].priority <= set[i].priority)
+                next += ((r + set[j].period - 1) / set[j].period) * set[j].wcet;
+
+        if (next > set[i].deadline)
+            return 0;
+        if (next == r)
+            return r;
+        r = next;
+    }
+}
+
+/*
+* Function: pruneStopped()
+* drops tasks that are no longer running, returns true if any were dropped
+*/
+static bool pruneStopped(void)
+{
+    uint8_t i, kept = 0;
+    TCB *task;
+
+    for (i = 0; i < admittedCount; i++)
+    {
+        task = findTask(admitted[i].pid);
+        if (task && task->state != STATE_STOPPED)
+            admitted[kept++] = admitted[i];
+    }
+    i = admittedCount;
+    admittedCount = kept;
+    return kept != i;
+}
+
+/*
+* Function: admissionTest()
+* runs the response time analysis with a new periodic task added (times in us)
+* returns true if every task still meets its deadline; admissionCommit() then records it
+*/
+bool admissionTest(uint8_t priority, uint32_t wcet, uint32_t period, uint32_t deadline)
+{
+    uint8_t i, k, first;
+    uint32_t seed, r;
+    bool rebuilt;
+
+    if (wcet == 0 || period == 0 || deadline == 0 || deadline > period)
+        return false;
+
+    // entries of stopped or killed tasks must not count against the capacity
+    rebuilt = pruneStopped();
+    if (admittedCount == MAX_ADMITTED)
+        return false;
+
+    // insert the new task after all tasks of higher or equal priority
+    for (k = 0; k < admittedCount && admitted[k].priority <= priority; k++);
+    for (i = 0; i < k; i++)
+        candidate[i] = admitted[i];
+    candidate[k].pid = 0;
+    candidate[k].priority = priority;
+    candidate[k].wcet = wcet;
+    candidate[k].period = period;
+    candidate[k].deadline = deadline;
+    for (i = k; i < admittedCount; i++)
+        candidate[i + 1] = admitted[i];
+    candidateCount = admittedCount + 1;
+
+    // after a task left, the remaining response times shrink and are no lower bound anymore
+    first = rebuilt ? 0 : k;
+    for (i = first; i < candidateCount; i++)
+    {
+        if (rebuilt || i == k)
+        {
+            // nearest task with a strictly higher priority already has its final response time
+            seed = candidate[i].wcet;
+            for (r = i; r > 0; r--)
+            {
+                if (candidate[r - 1].priority < candidate[i].priority)
+                {
+                    seed += candidate[r - 1].response;
+                    break;
+                }
+            }
+        }
+        else
+            seed = candidate[i].response + wcet;       // lower priority task, old response + C_k
+
+        candidate[i].response = responseTime(candidate, candidateCount, i, seed);
+        if (candidate[i].response == 0)
+        {
+            candidateCount = 0;
+            return false;
+        }
+    }
+
+    // equal priority tasks above the new one are interfered by it as well
+    for (i = 0; i < k && !rebuilt; i++)
+    {
+        if (candidate[i].priority == priority)
+        {
+            candidate[i].response = responseTime(candidate, candidateCount, i, candidate[i].response + wcet);
+            if (candidate[i].response == 0)
+            {
+                candidateCount = 0;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+* Function: admissionCommit()
+* makes the task set of the last successful admissionTest() current, with the pid of the new task
+*/
+void admissionCommit(uint32_t pid)
+{
+    uint8_t i;
+
+    for (i = 0; i < candidateCount; i++)
+    {
+        if (candidate[i].pid == 0)
+            candidate[i].pid = pid;
+        admitted[i] = candidate[i];
+    }
+    admittedCount = candidateCount;
+    candidateCount = 0;
+}
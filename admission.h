@@ -0,0 +1,36 @@
+/*
+ *      Filename: admission.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef ADMISSION_H_
+#define ADMISSION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Admission Control Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_ADMITTED            8
+
+// one admitted periodic task, all times in microseconds
+typedef struct _ADMITTED_TASK
+{
+    uint32_t pid;
+    uint8_t priority;
+    uint32_t wcet;                          // C, declared worst case execution time
+    uint32_t period;                        // T
+    uint32_t deadline;                      // D <= T
+    uint32_t response;                      // R, worst case response time from the analysis
+} ADMITTED_TASK;
+
+extern ADMITTED_TASK admitted[MAX_ADMITTED];
+extern uint8_t admittedCount;
+
+bool admissionTest(uint8_t priority, uint32_t wcet, uint32_t period, uint32_t deadline);
+void admissionCommit(uint32_t pid);
+
+#endif
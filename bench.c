@@ -0,0 +1,498 @@
+/*
+ *      Filename: bench.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Kernel micro-benchmarks, run from the shell with "bench <test>"
+// All timings are in system clock cycles (40 MHz) read from the DWT cycle counter
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "kernel.h"
+#include "terminal.h"
+#include "uart0.h"
+#include "mutex.h"
+#include "ring.h"
+#include "syscall.h"
+#include "heap.h"
+#include "heapref.h"
+#include "mpu.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#define BENCH_TASKS             32
+
+static TCB *benchTcb;                           // heap block, held only while the benchmark runs
+static READY_QUEUE benchQueue;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: printCycles()
+* prints "<label><cycles> cycles"
+*/
+static void printCycles(const char label[], uint32_t cycles)
+{
+    char str[MAX_INT_STR_LENGTH + 1];
+    putsUart0((char *) label);
+    putsUart0(integerToAlphabet(cycles, str));
+    putsUart0(" cycles");
+}
+
+/*
+* Function: cycleCounterOverhead()
+* cycles spent by two back-to-back reads of the cycle counter, subtracted from every sample
+*/
+static uint32_t cycleCounterOverhead(void)
+{
+    uint32_t start = DWT_CYCCNT_R;
+    return DWT_CYCCNT_R - start;
+}
+
+/*
+* Function: linearPickNext()
+* reference scheduler: scans the whole task table for the highest priority ready task
+*/
+static TCB *linearPickNext(TCB table[], uint8_t count)
+{
+    TCB *best = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+        if (table[i].state == STATE_READY && (best == 0 || table[i].priority < best->priority))
+            best = &table[i];
+    return best;
+}
+
+/*
+* Function: benchScheduler()
+* pick-next cost of the bitmap scheduler against a linear scan with 1, 8 and 32 ready tasks
+*/
+void benchScheduler(void)
+{
+    static const uint8_t readyCounts[] = {1, 8, 32};
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t start, bitmapTotal, linearTotal;
+    char str[MAX_INT_STR_LENGTH + 1];
+    uint8_t i, j, count;
+    uint16_t k;
+    TCB * volatile picked;
+
+    benchTcb = heapAllocate(BENCH_TASKS * sizeof(TCB), 0, HEAP_SPAN_REGIONS);
+    if (benchTcb == 0)
+    {
+        putsUart0("Not enough heap for the benchmark tasks");
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+        return;
+    }
+
+    for (i = 0; i < sizeof(readyCounts); i++)
+    {
+        count = readyCounts[i];
+
+        benchQueue.bitmap = 0;
+        for (j = 0; j < NUM_PRIORITIES; j++)
+            benchQueue.head[j] = 0;
+
+        // spread the tasks over the priority levels, highest priority last in the table
+        for (j = 0; j < count; j++)
+        {
+            benchTcb[j].state = STATE_READY;
+            benchTcb[j].priority = LOWEST_PRIORITY - j * (NUM_PRIORITIES / count);
+            readyQueueInsert(&benchQueue, &benchTcb[j], benchTcb[j].priority);
+        }
+        for (; j < BENCH_TASKS; j++)
+            benchTcb[j].state = STATE_INVALID;
+
+        bitmapTotal = 0;
+        linearTotal = 0;
+        for (k = 0; k < BENCH_ITERATIONS; k++)
+        {
+            start = DWT_CYCCNT_R;
+            picked = readyQueuePeek(&benchQueue);
+            bitmapTotal += DWT_CYCCNT_R - start - overhead;
+
+            start = DWT_CYCCNT_R;
+            picked = linearPickNext(benchTcb, BENCH_TASKS);
+            linearTotal += DWT_CYCCNT_R - start - overhead;
+        }
+
+        putsUart0("ready tasks: ");
+        putsUart0(integerToAlphabet(count, str));
+        printCycles("\tbitmap: ", bitmapTotal / BENCH_ITERATIONS);
+        printCycles("\tlinear: ", linearTotal / BENCH_ITERATIONS);
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+    heapRelease(benchTcb, 0);
+    (void) picked;
+}
+
+/*
+* Function: measureSwitch()
+* average cycles of a yield() that switches out of and back into the calling task,
+* covering exception entry, pendSvISR, the scheduler and exception return
+*/
+static uint32_t measureSwitch(bool useFpu, uint32_t overhead)
+{
+    static volatile float operand = 1.0f;
+    uint32_t start, total = 0;
+    uint16_t k;
+
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        if (useFpu)
+            operand = operand * 1.0001f;    // gives this task an active FP context
+        start = DWT_CYCCNT_R;
+        yield();
+        total += DWT_CYCCNT_R - start - overhead;
+    }
+    return total / BENCH_ITERATIONS;
+}
+
+/*
+* Function: benchFpu()
+* context switch cost of an integer-only task against a task with an active FP context
+*/
+void benchFpu(void)
+{
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t integerCycles, fpCycles;
+
+    // the shell has to be alone on its level so each yield() comes straight back
+    if (taskCurrent->next != taskCurrent)
+    {
+        putsUart0("bench fpu needs sched prio with the shell alone on its priority\n\r");
+        return;
+    }
+
+    clearFpuContext();
+    integerCycles = measureSwitch(false, overhead);
+    fpCycles = measureSwitch(true, overhead);
+    clearFpuContext();
+
+    printCycles("non-FP switch: ", integerCycles);
+    printCycles("\tFP switch: ", fpCycles);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: measureMutex()
+* average uncontended lock and unlock cycles of a mutex taken by the calling task
+*/
+static void measureMutex(const char label[], uint8_t mutex, uint32_t overhead)
+{
+    uint32_t start, lockTotal = 0, unlockTotal = 0;
+    uint16_t k;
+
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        start = DWT_CYCCNT_R;
+        lockMutex(mutex);
+        lockTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        unlockMutex(mutex);
+        unlockTotal += DWT_CYCCNT_R - start - overhead;
+    }
+
+    putsUart0((char *) label);
+    printCycles("lock: ", lockTotal / BENCH_ITERATIONS);
+    printCycles("\tunlock: ", unlockTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: benchMutex()
+* lock/unlock cost of a priority inheritance mutex against priority ceiling mutexes
+*/
+void benchMutex(void)
+{
+    static uint8_t inheritMutex = INVALID_MUTEX;
+    static uint8_t ceilingMutex = INVALID_MUTEX;
+    static uint8_t basepriMutex = INVALID_MUTEX;
+    uint32_t overhead = cycleCounterOverhead();
+
+    // created on first use and kept for later runs
+    if (inheritMutex == INVALID_MUTEX)
+    {
+        inheritMutex = createMutex("benchPi");
+        ceilingMutex = createCeilingMutex("benchPcp", taskCurrent->basePriority / 2, 0);
+        basepriMutex = createCeilingMutex("benchPcpIsr", taskCurrent->basePriority / 2, 6);
+    }
+    if (inheritMutex == INVALID_MUTEX || ceilingMutex == INVALID_MUTEX || basepriMutex == INVALID_MUTEX)
+    {
+        putsUart0("bench mutex: out of mutexes\n\r");
+        return;
+    }
+
+    measureMutex("inheritance:       ", inheritMutex, overhead);
+    measureMutex("ceiling:           ", ceilingMutex, overhead);
+    measureMutex("ceiling + BASEPRI: ", basepriMutex, overhead);
+}
+
+/*
+* Function: checkRing()
+* pushes and pops a numbered byte stream in spans of pseudo-random length across the
+* 2^32 wrap of the free-running indices, returns false if a byte is lost or out of order
+*/
+static bool checkRing(RING *r)
+{
+    uint32_t seed = DWT_CYCCNT_R;
+    uint8_t out[BENCH_RING_SIZE], in[BENCH_RING_SIZE];
+    uint8_t sent = 0, expected = 0;
+    uint32_t total = 0;
+    uint32_t n, i, pushed, popped;
+
+    r->head = r->tail = 0xFFFFFF00;
+    while (total < BENCH_RING_BYTES)
+    {
+        seed = seed * 1664525 + 1013904223;
+        n = (seed >> 24) % BENCH_RING_SIZE + 1;
+        for (i = 0; i < n; i++)
+            out[i] = sent + i;
+        pushed = ringPushSpan(r, out, n);
+        sent += pushed;
+
+        seed = seed * 1664525 + 1013904223;
+        n = (seed >> 24) % BENCH_RING_SIZE + 1;
+        popped = ringPopSpan(r, in, n);
+        for (i = 0; i < popped; i++)
+            if (in[i] != expected++)
+                return false;
+        total += popped;
+        if (ringCount(r) > BENCH_RING_SIZE)
+            return false;
+    }
+    return (uint8_t) (r->head - r->tail) == (uint8_t) (sent - expected);
+}
+
+/*
+* Function: benchRing()
+* checks the SPSC ring and compares the per-byte cost of single and span transfers
+*/
+void benchRing(void)
+{
+    static uint8_t buffer[BENCH_RING_SIZE];
+    uint8_t data[BENCH_RING_SIZE];
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t start, singleTotal = 0, spanTotal = 0;
+    uint16_t k;
+    uint8_t i, c;
+    RING r;
+
+    initRing(&r, buffer, BENCH_RING_SIZE);
+    putsUart0(checkRing(&r) ? "ring check: pass\n\r" : "ring check: FAIL\n\r");
+
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        start = DWT_CYCCNT_R;
+        for (i = 0; i < BENCH_RING_SIZE; i++)
+            ringPush(&r, i);
+        for (i = 0; i < BENCH_RING_SIZE; i++)
+            ringPop(&r, &c);
+        singleTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        ringPushSpan(&r, data, BENCH_RING_SIZE);
+        ringPopSpan(&r, data, BENCH_RING_SIZE);
+        spanTotal += DWT_CYCCNT_R - start - overhead;
+    }
+
+    printCycles("push + pop per byte, single: ", singleTotal / (BENCH_ITERATIONS * BENCH_RING_SIZE));
+    printCycles("\tspan: ", spanTotal / (BENCH_ITERATIONS * BENCH_RING_SIZE));
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: nullFunction()
+* reference for the syscall gate: a plain call that does nothing
+*/
+static uint32_t nullFunction(void)
+{
+    return 0;
+}
+
+/*
+* Function: benchSvc()
+* round trip of a null system call through the SVC gate against a plain function call
+*/
+void benchSvc(void)
+{
+    uint32_t (*volatile direct)(void) = nullFunction;   // keeps the call from being inlined away
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t start, svcTotal = 0, callTotal = 0;
+    uint16_t k;
+
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        start = DWT_CYCCNT_R;
+        svcNull();
+        svcTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        direct();
+        callTotal += DWT_CYCCNT_R - start - overhead;
+    }
+
+    printCycles("null syscall: ", svcTotal / BENCH_ITERATIONS);
+    printCycles("\tfunction call: ", callTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: checkHeap()
+* compares heapFindRun() with the reference on random free maps and sizes, returns the mismatches
+*/
+static uint32_t checkHeap(void)
+{
+    uint32_t seed = DWT_CYCCNT_R;
+    uint32_t mismatches = 0;
+    uint32_t size;
+    uint64_t freeMap;
+    uint8_t flags, fast, naive, fastCount = 0, naiveCount = 0;
+    uint16_t k;
+
+    for (k = 0; k < BENCH_HEAP_CHECKS; k++)
+    {
+        freeMap = randomFreeMap(&seed);
+        size = randomHeapSize(&seed);
+        flags = (seed >> 4) & (HEAP_SPAN_REGIONS | HEAP_ALIGNED);
+        fast = heapFindRun(freeMap, size, flags, &fastCount);
+        naive = naiveFindRun(freeMap, size, flags, &naiveCount);
+        if (fast != naive || (fast != HEAP_SUBREGIONS && fastCount != naiveCount))
+            mismatches++;
+    }
+    return mismatches;
+}
+
+/*
+* Function: benchHeap()
+* checks the heap search against the reference, then compares their cost and times an
+* allocate + release pair on the live heap
+*/
+void benchHeap(void)
+{
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t start, fastTotal = 0, naiveTotal = 0, pairTotal = 0;
+    uint32_t seed = 1, size, mismatches;
+    char str[MAX_INT_STR_LENGTH + 1];
+    uint64_t freeMap;
+    uint8_t flags, count;
+    uint16_t k;
+    void *block;
+
+    mismatches = checkHeap();
+    putsUart0("heap check: ");
+    putsUart0(mismatches ? "FAIL, mismatches " : "pass");
+    if (mismatches)
+        putsUart0(integerToAlphabet(mismatches, str));
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        freeMap = randomFreeMap(&seed);
+        size = randomHeapSize(&seed);
+        flags = (seed >> 4) & (HEAP_SPAN_REGIONS | HEAP_ALIGNED);
+
+        start = DWT_CYCCNT_R;
+        heapFindRun(freeMap, size, flags, &count);
+        fastTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        naiveFindRun(freeMap, size, flags, &count);
+        naiveTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        block = heapAllocate(HEAP_SMALL_SIZE, 0, 0);
+        heapRelease(block, 0);
+        pairTotal += DWT_CYCCNT_R - start - overhead;
+    }
+
+    printCycles("best fit search, bitmap: ", fastTotal / BENCH_ITERATIONS);
+    printCycles("	per subregion: ", naiveTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    printCycles("allocate + release: ", pairTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: benchMpu()
+* cost of loading an SRAM access mask on a switch: register by register against the
+* precomputed table, with all regions burst out, one region changed and none changed
+* the masks only add access to the caller's own, so it keeps running with isolation on
+*/
+void benchMpu(void)
+{
+    static SRAM_REGION_TABLE tableA, tableB;
+    uint64_t maskA = taskCurrent->srd;
+    uint64_t maskB = maskA | (0xFFULL << 40);   // differs in region 7 at most
+    uint32_t overhead = cycleCounterOverhead();
+    uint32_t start, naiveTotal = 0, burstTotal = 0, deltaTotal = 0, sameTotal = 0;
+    uint32_t irqState;
+    uint16_t k;
+
+    buildSramRegionTable(&tableA, maskA);
+    buildSramRegionTable(&tableB, maskB);
+
+    irqState = _disable_interrupts();
+    for (k = 0; k < BENCH_ITERATIONS; k++)
+    {
+        start = DWT_CYCCNT_R;
+        applySramAccessMask(k & 1 ? maskB : maskA);
+        naiveTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        loadMpuRegions(k & 1 ? tableB.regions : tableA.regions, SRAM_REGIONS);
+        burstTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        applySramRegionTable(&tableB, maskB);
+        applySramRegionTable(&tableA, maskA);
+        deltaTotal += DWT_CYCCNT_R - start - overhead;
+
+        start = DWT_CYCCNT_R;
+        applySramRegionTable(&tableA, maskA);
+        sameTotal += DWT_CYCCNT_R - start - overhead;
+    }
+    applySramAccessMask(maskA);
+    _restore_interrupts(irqState);
+
+    printCycles("SRAM mask load, per register: ", naiveTotal / BENCH_ITERATIONS);
+    printCycles("\tburst, all regions: ", burstTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    printCycles("delta, 1 region: ", deltaTotal / (2 * BENCH_ITERATIONS));
+    printCycles("\tdelta, unchanged: ", sameTotal / BENCH_ITERATIONS);
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+/*
+* Function: bench()
+* runs the benchmark named by the shell argument
+*/
+void bench(const char test[])
+{
+    if (stringCompare(test, "sched"))
+        benchScheduler();
+    else if (stringCompare(test, "fpu"))
+        benchFpu();
+    else if (stringCompare(test, "mutex"))
+        benchMutex();
+    else if (stringCompare(test, "ring"))
+        benchRing();
+    else if (stringCompare(test, "svc"))
+        benchSvc();
+    else if (stringCompare(test, "heap"))
+        benchHeap();
+    else if (stringCompare(test, "mpu"))
+        benchMpu();
+    else
+        putsUart0("bench: sched, fpu, mutex, ring, svc, heap, mpu\n\r");
+}
@@ -0,0 +1,27 @@
+/*
+ *      Filename: bench.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#define BENCH_ITERATIONS        100         // samples averaged per measurement
+#define BENCH_RING_SIZE         32          // ring used by "bench ring", power of two
+#define BENCH_RING_BYTES        4096        // bytes streamed through it by the check
+#define BENCH_HEAP_CHECKS       1000        // random free maps compared by "bench heap"
+
+void bench(const char test[]);
+void benchScheduler(void);
+void benchFpu(void);
+void benchMutex(void);
+void benchRing(void);
+void benchSvc(void);
+void benchHeap(void);
+void benchMpu(void);
+
+#endif
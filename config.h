@@ -0,0 +1,25 @@
+/*
+ *      Filename: config.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+//-----------------------------------------------------------------------------
+// Kernel Configuration
+//-----------------------------------------------------------------------------
+
+// number of objects in each kernel object pool (slab.h), all at most 254 so a
+// handle fits in a byte next to the 0xFF invalid handle
+#define MAX_TASKS               12
+#define MAX_MUTEXES             8
+#define MAX_SEMAPHORES          8
+#define MAX_QUEUES              4
+#define MAX_EVENT_GROUPS        8
+#define MAX_TIMERS              8
+#define MAX_SHARED_MEMORY       4
+
+#endif
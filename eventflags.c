@@ -0,0 +1,207 @@
+/*
+ *      Filename: eventflags.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Event flag groups
+//
+// A group holds 32 flags. A task blocks until any or all flags of its mask are
+// set, optionally clearing the ones that released it. Setting flags only ORs
+// them in and, if the group has waiters, marks it in a pending bitmap and pends
+// PendSV, so it costs the same from an interrupt handler no matter how many
+// tasks wait. The wake pass runs from taskSwitch(): each pending group's wait
+// queue is walked once, every satisfied waiter is readied against the same
+// snapshot of the flags, and the auto-clear flags of all of them are removed
+// together at the end of the pass.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tm4c123gh6pm.h"
+#include "kernel.h"
+#include "eventflags.h"
+#include "semaphore.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+EVENT_GROUP eventGroups[MAX_EVENT_GROUPS];
+SLAB eventGroupPool = SLAB_INIT("events", eventGroups, EVENT_GROUP, waiters);
+
+// bit (31 - group) is set while the group has new flags its waiters have not seen
+static volatile uint32_t pendingGroups = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: satisfied()
+* flags that release a waiter, 0 if it has to keep waiting
+*/
+static uint32_t satisfied(uint32_t flags, EVENT_WAIT *wait)
+{
+    uint32_t hit = flags & wait->mask;
+
+    if (wait->options & EVENT_ALL)
+        return hit == wait->mask ? hit : 0;
+    return hit;
+}
+
+/*
+* Function: createEventGroup()
+* returns the handle of a new group with all flags clear, INVALID_EVENT_GROUP if none is free
+*/
+uint8_t createEventGroup(const char name[])
+{
+    uint8_t i, j;
+    EVENT_GROUP *object;
+    uint32_t irqState = _disable_interrupts();
+
+    object = slabAlloc(&eventGroupPool);
+    if (object == 0)
+    {
+        _restore_interrupts(irqState);
+        return INVALID_EVENT_GROUP;
+    }
+    i = slabIndex(&eventGroupPool, object);
+
+    eventGroups[i].valid = true;
+    eventGroups[i].flags = 0;
+    eventGroups[i].waiters = 0;
+    eventGroups[i].sets = 0;
+    eventGroups[i].wakeups = 0;
+    for (j = 0; j < MAX_EVENT_NAME_LENGTH && name[j] != 0; j++)
+        eventGroups[i].name[j] = name[j];
+    eventGroups[i].name[j] = 0;
+
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: setEventFlags()
+* sets flags and defers waking the waiters to the next PendSV
+* may be called from interrupt handlers
+*/
+bool setEventFlags(uint8_t group, uint32_t mask)
+{
+    EVENT_GROUP *g = &eventGroups[group];
+    uint32_t irqState;
+
+    if (group >= MAX_EVENT_GROUPS || !g->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    g->flags |= mask;
+    g->sets++;
+    if (g->waiters)
+    {
+        pendingGroups |= 0x80000000 >> group;
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    }
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: clearEventFlags()
+* clears flags without waking anybody
+*/
+bool clearEventFlags(uint8_t group, uint32_t mask)
+{
+    EVENT_GROUP *g = &eventGroups[group];
+    uint32_t irqState;
+
+    if (group >= MAX_EVENT_GROUPS || !g->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    g->flags &= ~mask;
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: waitEventFlags()
+* waits up to timeoutMs (NO_WAIT, WAIT_FOREVER) until any (EVENT_ANY) or all (EVENT_ALL) flags of
+* the mask are set, EVENT_CLEAR clears them on the way out
+* returns the flags of the mask that were set, 0 on timeout, task context only
+*/
+uint32_t waitEventFlags(uint8_t group, uint32_t mask, uint8_t options, uint32_t timeoutMs)
+{
+    EVENT_GROUP *g = &eventGroups[group];
+    EVENT_WAIT wait;
+    uint32_t irqState;
+
+    if (group >= MAX_EVENT_GROUPS || !g->valid || mask == 0)
+        return 0;
+
+    wait.mask = mask;
+    wait.options = options;
+    wait.result = 0;
+
+    irqState = _disable_interrupts();
+    wait.result = satisfied(g->flags, &wait);
+    if (wait.result || timeoutMs == NO_WAIT)
+    {
+        if (options & EVENT_CLEAR)
+            g->flags &= ~wait.result;
+        _restore_interrupts(irqState);
+        return wait.result;
+    }
+
+    taskCurrent->waitData = &wait;
+    if (timeoutMs == WAIT_FOREVER)
+        blockCurrentTask(&g->waiters, g);
+    else
+        blockCurrentTaskTimeout(&g->waiters, g, msToTicks(timeoutMs));
+    _restore_interrupts(irqState);
+
+    // wakeEventWaiters() fills in the result, it stays 0 after a timeout
+    return wait.result;
+}
+
+/*
+* Function: wakeEventWaiters()
+* readies every waiter of the pending groups whose condition holds, called from taskSwitch()
+* right before the scheduler runs, so the waiters are queued without pending another PendSV
+*/
+void wakeEventWaiters(void)
+{
+    EVENT_GROUP *g;
+    EVENT_WAIT *wait;
+    TCB *task, *next;
+    uint32_t flags, clear;
+    uint8_t group;
+    uint32_t irqState = _disable_interrupts();
+
+    while (pendingGroups)
+    {
+        group = CLZ(pendingGroups);
+        pendingGroups &= ~(0x80000000 >> group);
+        g = &eventGroups[group];
+
+        flags = g->flags;
+        clear = 0;
+        for (task = g->waiters; task != 0; task = next)
+        {
+            next = task->waitNext;
+            wait = task->waitData;
+            wait->result = satisfied(flags, wait);
+            if (wait->result)
+            {
+                if (wait->options & EVENT_CLEAR)
+                    clear |= wait->result;
+                waitQueueRemove(&g->waiters, task);
+                makeReady(task);
+                g->wakeups++;
+            }
+        }
+        g->flags &= ~clear;
+    }
+    _restore_interrupts(irqState);
+}
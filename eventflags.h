@@ -0,0 +1,54 @@
+/*
+ *      Filename: eventflags.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef EVENTFLAGS_H_
+#define EVENTFLAGS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Event Flag Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_EVENT_NAME_LENGTH   15
+#define INVALID_EVENT_GROUP     0xFF
+
+// waitEventFlags() options
+#define EVENT_ANY               0x00        // wake when any flag of the mask is set
+#define EVENT_ALL               0x01        // wake when every flag of the mask is set
+#define EVENT_CLEAR             0x02        // clear the flags that woke the task
+
+typedef struct _EVENT_GROUP
+{
+    bool valid;
+    volatile uint32_t flags;
+    TCB *waiters;                           // blocked tasks, highest priority first
+    char name[MAX_EVENT_NAME_LENGTH + 1];
+    uint32_t sets;                          // setEventFlags() calls
+    uint32_t wakeups;                       // waiters released
+} EVENT_GROUP;
+
+// what a blocked task waits for, kept on its stack and reached through waitData
+typedef struct _EVENT_WAIT
+{
+    uint32_t mask;
+    uint8_t options;
+    uint32_t result;                        // flags that released the task
+} EVENT_WAIT;
+
+extern EVENT_GROUP eventGroups[MAX_EVENT_GROUPS];
+extern SLAB eventGroupPool;
+
+uint8_t createEventGroup(const char name[]);
+bool setEventFlags(uint8_t group, uint32_t mask);
+bool clearEventFlags(uint8_t group, uint32_t mask);
+uint32_t waitEventFlags(uint8_t group, uint32_t mask, uint8_t options, uint32_t timeoutMs);
+void wakeEventWaiters(void);
+
+#endif
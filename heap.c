@@ -0,0 +1,388 @@
+/*
+ *      Filename: heap.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// MPU-aware task heap
+//
+// The heap is handed out in whole MPU subregions, so the blocks of one task
+// never share a subregion with another task's and the task's SRAM access mask
+// can open exactly its own blocks. The first subregion of a block records its
+// owner and length. Allocating adds the block to the owner's access mask,
+// releasing takes it out again; blocks the kernel keeps for itself
+// (HEAP_KERNEL) are in nobody's mask.
+//
+// Free subregions are bits of heapFreeMap, in the same order as the heap bits
+// of the access mask. A block is placed in the tightest free run that holds it
+// (best fit), found with shift-AND and CLZ/CTZ word operations rather than a
+// scan of the subregions; by default the run may not straddle an MPU region.
+//
+// Stacks come from here too, owned by their task.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "heap.h"
+#include "mpu.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#pragma DATA_SECTION(heap, ".taskheap")
+static uint8_t heap[HEAP_BYTES];
+
+uint32_t heapOwner[HEAP_SUBREGIONS];            // pid owning the block starting at each subregion, or HEAP_KERNEL
+uint64_t heapFreeMap = (1ULL << HEAP_SUBREGIONS) - 1;   // bit i set while subregion i is free
+static uint8_t heapRun[HEAP_SUBREGIONS];        // subregions in the block starting here, 0 elsewhere
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: subregionAddress()
+* start of a heap subregion
+*/
+static uint8_t *subregionAddress(uint8_t index)
+{
+    if (index < HEAP_SMALL_SUBREGIONS)
+        return &heap[index * HEAP_SMALL_SIZE];
+    return &heap[HEAP_SMALL_SUBREGIONS * HEAP_SMALL_SIZE + (index - HEAP_SMALL_SUBREGIONS) * HEAP_LARGE_SIZE];
+}
+
+/*
+* Function: subregionSize()
+* size of a heap subregion
+*/
+static uint32_t subregionSize(uint8_t index)
+{
+    return index < HEAP_SMALL_SUBREGIONS ? HEAP_SMALL_SIZE : HEAP_LARGE_SIZE;
+}
+
+/*
+* Function: subregionIndex()
+* heap subregion a block starts at, HEAP_SUBREGIONS if the address is not the start of a block
+*/
+static uint8_t subregionIndex(void *block)
+{
+    uint8_t *address = block;
+    uint32_t offset = address - heap;
+    uint8_t index;
+
+    if (address < heap || offset >= HEAP_BYTES)
+        return HEAP_SUBREGIONS;
+    if (offset < HEAP_SMALL_SUBREGIONS * HEAP_SMALL_SIZE)
+    {
+        if (offset % HEAP_SMALL_SIZE)
+            return HEAP_SUBREGIONS;
+        index = offset / HEAP_SMALL_SIZE;
+    }
+    else
+    {
+        offset -= HEAP_SMALL_SUBREGIONS * HEAP_SMALL_SIZE;
+        if (offset % HEAP_LARGE_SIZE)
+            return HEAP_SUBREGIONS;
+        index = HEAP_SMALL_SUBREGIONS + offset / HEAP_LARGE_SIZE;
+    }
+    return heapRun[index] ? index : HEAP_SUBREGIONS;
+}
+
+/*
+* Function: runStarts()
+* bits i of a word where bits i..i+n-1 are all set, by shift-AND doubling (log2 n steps)
+*/
+static uint32_t runStarts(uint32_t bits, uint8_t n)
+{
+    uint8_t length = 1, shift;
+
+    while (length < n && bits)
+    {
+        shift = length < n - length ? length : n - length;
+        bits &= bits >> shift;
+        length += shift;
+    }
+    return bits;
+}
+
+/*
+* Function: bestFitRun()
+* start of the shortest run of free bits holding n subregions, 32 if none
+* joins has bit i set when subregions i and i+1 may be in one block; the run length is returned in length
+*/
+static uint8_t bestFitRun(uint32_t free, uint8_t n, uint32_t joins, uint8_t *length)
+{
+    uint32_t pairs = free & (free >> 1) & joins;    // bit i: i and i+1 free and joinable
+    uint32_t starts, candidate;
+    uint8_t best = 32, run;
+
+    *length = 32 + 1;
+    if (n == 0 || n > 32 || (n == 1 ? free : runStarts(pairs, n - 1)) == 0)
+        return best;
+
+    // visit each free run once through its first bit, CTZ of the pair bits gives its length
+    starts = free & ~(pairs << 1);
+    while (starts)
+    {
+        candidate = CTZ(starts);
+        starts &= starts - 1;
+        run = CTZ(~(pairs >> candidate)) + 1;
+        if (run >= n && run < *length)
+        {
+            best = candidate;
+            *length = run;
+            if (run == n)
+                break;
+        }
+    }
+    return best;
+}
+
+/*
+* Function: alignedFitRun()
+* lowest run of n free bits (n a power of two) whose address is a multiple of its size, 32 if none
+* base is the address of bit 0 in units of the subregion size, the alignment is against the
+* address rather than the bit index because the heap itself is not aligned to every block size
+*/
+static uint8_t alignedFitRun(uint32_t free, uint8_t n, uint32_t joins, uint32_t base)
+{
+    uint32_t pairs = free & (free >> 1) & joins;
+    uint32_t fits, aligned;
+
+    if (n == 0 || n > 32)
+        return 32;
+    aligned = (uint32_t) (0xFFFFFFFFULL / ((1ULL << n) - 1)) << ((0 - base) & (n - 1));
+    fits = (n == 1 ? free : runStarts(pairs, n - 1)) & aligned;
+    return fits ? CTZ(fits) : 32;
+}
+
+/*
+* Function: heapFindRun()
+* subregion a block of size bytes would start at in a free map, HEAP_SUBREGIONS if it does not fit
+* the block takes count subregions; the 512B and 1KiB parts are searched separately, the tighter
+* fit wins, and with HEAP_SPAN_REGIONS a block may take the top of the one and the bottom of the other
+*/
+uint8_t heapFindRun(uint64_t freeMap, uint32_t size, uint8_t flags, uint8_t *count)
+{
+    uint32_t small = (uint32_t) freeMap;
+    uint32_t large = (uint32_t) (freeMap >> HEAP_SMALL_SUBREGIONS);
+    uint32_t smallN = (size + HEAP_SMALL_SIZE - 1) / HEAP_SMALL_SIZE;
+    uint32_t largeN = (size + HEAP_LARGE_SIZE - 1) / HEAP_LARGE_SIZE;
+    uint8_t smallStart, largeStart, smallRun, largeRun, top, bottom;
+
+    if (size == 0 || size > HEAP_BYTES)
+        return HEAP_SUBREGIONS;
+
+    // aligned blocks take the lowest aligned run, in the 512B subregions if they fit there
+    if (flags & HEAP_ALIGNED)
+    {
+        smallN = smallN > 1 ? 1UL << (32 - CLZ(smallN - 1)) : 1;
+        largeN = largeN > 1 ? 1UL << (32 - CLZ(largeN - 1)) : 1;
+        smallStart = alignedFitRun(small, smallN, flags & HEAP_SPAN_REGIONS ? HEAP_SMALL_SPAN_JOINS : HEAP_SMALL_JOINS,
+                                   HEAP_BASE / HEAP_SMALL_SIZE);
+        largeStart = alignedFitRun(large, largeN, HEAP_LARGE_JOINS, HEAP_LARGE_BASE / HEAP_LARGE_SIZE);
+        if (smallStart < 32)
+        {
+            *count = smallN;
+            return smallStart;
+        }
+        if (largeStart < 32)
+        {
+            *count = largeN;
+            return HEAP_SMALL_SUBREGIONS + largeStart;
+        }
+        return HEAP_SUBREGIONS;
+    }
+
+    smallStart = bestFitRun(small, smallN, flags & HEAP_SPAN_REGIONS ? HEAP_SMALL_SPAN_JOINS : HEAP_SMALL_JOINS, &smallRun);
+    largeStart = bestFitRun(large, largeN, HEAP_LARGE_JOINS, &largeRun);
+
+    // tighter run wins, measured in bytes left over in it; ties keep the 1KiB subregions free
+    if (smallStart < 32 && (largeStart == 32 ||
+        smallRun * HEAP_SMALL_SIZE - size <= largeRun * HEAP_LARGE_SIZE - size))
+    {
+        *count = smallN;
+        return smallStart;
+    }
+    if (largeStart < 32)
+    {
+        *count = largeN;
+        return HEAP_SMALL_SUBREGIONS + largeStart;
+    }
+
+    // last resort: free 512B subregions at the top of region 6 continued by 1KiB ones in region 7
+    if (!(flags & HEAP_SPAN_REGIONS))
+        return HEAP_SUBREGIONS;
+    top = CLZ(~small);
+    bottom = CTZ(~large);
+    largeN = size > top * HEAP_SMALL_SIZE ? (size - top * HEAP_SMALL_SIZE + HEAP_LARGE_SIZE - 1) / HEAP_LARGE_SIZE : 1;
+    smallN = size > largeN * HEAP_LARGE_SIZE ? (size - largeN * HEAP_LARGE_SIZE + HEAP_SMALL_SIZE - 1) / HEAP_SMALL_SIZE : 1;
+    if (top == 0 || largeN > bottom || smallN > top)
+        return HEAP_SUBREGIONS;
+    *count = smallN + largeN;
+    return HEAP_SMALL_SUBREGIONS - smallN;
+}
+
+/*
+* Function: heapAllocate()
+* best fit of a run of free subregions covering size bytes, owned by a task (0 for the kernel)
+* the block is added to the owner's SRAM access mask; returns 0 if no run is large enough
+*/
+void *heapAllocate(uint32_t size, TCB *owner, uint8_t flags)
+{
+    uint64_t run;
+    uint8_t first, count;
+    uint32_t irqState = _disable_interrupts();
+
+    first = heapFindRun(heapFreeMap, size, flags, &count);
+    if (first == HEAP_SUBREGIONS)
+    {
+        _restore_interrupts(irqState);
+        return 0;
+    }
+
+    run = ((1ULL << count) - 1) << first;
+    heapFreeMap &= ~run;
+    heapOwner[first] = owner ? owner->pid : HEAP_KERNEL;
+    heapRun[first] = count;
+    if (owner)
+        owner->srd |= run << HEAP_FIRST_SRD_BIT;
+    _restore_interrupts(irqState);
+    return subregionAddress(first);
+}
+
+/*
+* Function: heapRelease()
+* frees a block owned by a task (0 for the kernel) and takes it out of the task's access mask
+*/
+bool heapRelease(void *block, TCB *owner)
+{
+    uint8_t first = subregionIndex(block);
+    uint64_t run;
+    uint32_t irqState = _disable_interrupts();
+
+    if (first == HEAP_SUBREGIONS || heapOwner[first] != (owner ? owner->pid : HEAP_KERNEL))
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+
+    run = ((1ULL << heapRun[first]) - 1) << first;
+    if (owner)
+        owner->srd &= ~(run << HEAP_FIRST_SRD_BIT);
+    heapFreeMap |= run;
+    heapOwner[first] = HEAP_FREE;
+    heapRun[first] = 0;
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: heapReleaseTask()
+* frees every block a task owns, its stack included, and returns how many there were
+* only the subregions open in the task's access mask are visited, a block start at a time
+*/
+uint8_t heapReleaseTask(TCB *task)
+{
+    uint64_t candidates, run;
+    uint8_t first, count = 0;
+    uint32_t irqState = _disable_interrupts();
+
+    candidates = (task->srd >> HEAP_FIRST_SRD_BIT) & ~heapFreeMap & ((1ULL << HEAP_SUBREGIONS) - 1);
+    while (candidates)
+    {
+        first = (uint32_t) candidates ? CTZ((uint32_t) candidates) : 32 + CTZ((uint32_t) (candidates >> 32));
+        if (heapRun[first] && heapOwner[first] == task->pid)
+        {
+            run = ((1ULL << heapRun[first]) - 1) << first;
+            task->srd &= ~(run << HEAP_FIRST_SRD_BIT);
+            heapFreeMap |= run;
+            heapOwner[first] = HEAP_FREE;
+            heapRun[first] = 0;
+            candidates &= ~run;
+            count++;
+        }
+        else
+            candidates &= candidates - 1;                  // somebody else's block, shared or in transit
+    }
+    _restore_interrupts(irqState);
+    return count;
+}
+
+/*
+* Function: heapBlockSize()
+* usable size of a block, 0 if the address is not the start of a block
+*/
+uint32_t heapBlockSize(void *block)
+{
+    uint8_t first = subregionIndex(block);
+    uint32_t size = 0;
+    uint8_t i;
+
+    if (first == HEAP_SUBREGIONS)
+        return 0;
+    for (i = first; i < first + heapRun[first]; i++)
+        size += subregionSize(i);
+    return size;
+}
+
+/*
+* Function: mallocFromHeap()
+* allocates a block for the running task, rounded up to whole subregions
+*/
+void *mallocFromHeap(uint32_t size)
+{
+    void *block = heapAllocate(size, taskCurrent, 0);
+
+    if (block && getMpuIsolation())
+        applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+    return block;
+}
+
+/*
+* Function: freeToHeap()
+* returns a block of the running task to the heap
+*/
+bool freeToHeap(void *block)
+{
+    if (!heapRelease(block, taskCurrent))
+        return false;
+    if (getMpuIsolation())
+        applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+    return true;
+}
+
+/*
+* Function: heapAccessMask()
+* SRAM access mask that opens exactly the heap blocks of a task
+*/
+uint64_t heapAccessMask(uint32_t pid)
+{
+    uint64_t mask = createNoSramAcccessMask();
+    uint8_t i;
+
+    for (i = 0; i < HEAP_SUBREGIONS; i++)
+        if (heapRun[i] && heapOwner[i] == pid)
+            mask |= ((1ULL << heapRun[i]) - 1) << (HEAP_FIRST_SRD_BIT + i);
+    return mask;
+}
+
+/*
+* Function: heapFreeBytes()
+* total size of the free subregions
+*/
+uint32_t heapFreeBytes(void)
+{
+    uint32_t small = (uint32_t) heapFreeMap;
+    uint32_t large = (uint32_t) (heapFreeMap >> HEAP_SMALL_SUBREGIONS);
+    uint32_t free = 0;
+
+    for (; small; small &= small - 1)
+        free += HEAP_SMALL_SIZE;
+    for (; large; large &= large - 1)
+        free += HEAP_LARGE_SIZE;
+    return free;
+}
@@ -0,0 +1,56 @@
+/*
+ *      Filename: heap.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+
+//-----------------------------------------------------------------------------
+// Heap Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+// the heap is SRAM covered by MPU regions 3-7 (see HEAP in tm4c123gh6pm.cmd):
+// 32 subregions of 512B in regions 3-6 followed by 8 subregions of 1KiB in region 7
+#define HEAP_BASE               0x20002000
+#define HEAP_BYTES              0x6000
+#define HEAP_SMALL_SUBREGIONS   32
+#define HEAP_SMALL_SIZE         512
+#define HEAP_LARGE_SIZE         1024
+#define HEAP_LARGE_BASE         (HEAP_BASE + HEAP_SMALL_SUBREGIONS * HEAP_SMALL_SIZE)
+#define HEAP_SUBREGIONS         40
+#define HEAP_FIRST_SRD_BIT      8           // SRAM access mask bit of heap subregion 0 (region 3)
+#define HEAP_REGION_SUBREGIONS  8           // subregions per MPU region
+
+#define HEAP_SMALL_JOINS        0x7F7F7F7F  // bit i: small subregions i and i+1 are in the same MPU region
+#define HEAP_SMALL_SPAN_JOINS   0x7FFFFFFF  // same when a block may straddle regions 3-6
+#define HEAP_LARGE_JOINS        0x7F        // large subregions, all in region 7
+
+#define HEAP_SPAN_REGIONS       0x01        // heapAllocate() flag: the block may straddle MPU regions
+#define HEAP_ALIGNED            0x02        // heapAllocate() flag: power-of-two subregions at an address aligned to
+                                            // their size, so the block can also be covered by a single MPU region
+                                            // (at most 8KiB, the 16KiB of 512B subregions start at 0x20002000)
+
+#define HEAP_FREE               0           // heapOwner[] of a free subregion
+#define HEAP_KERNEL             0xFFFFFFFF  // heapOwner[] of a kernel allocation
+
+extern uint32_t heapOwner[HEAP_SUBREGIONS];
+extern uint64_t heapFreeMap;
+
+uint8_t heapFindRun(uint64_t freeMap, uint32_t size, uint8_t flags, uint8_t *count);
+void *heapAllocate(uint32_t size, TCB *owner, uint8_t flags);
+bool heapRelease(void *block, TCB *owner);
+uint8_t heapReleaseTask(TCB *task);
+uint32_t heapBlockSize(void *block);
+void *mallocFromHeap(uint32_t size);
+bool freeToHeap(void *block);
+uint64_t heapAccessMask(uint32_t pid);
+uint32_t heapFreeBytes(void);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ *      Filename: heapref.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Reference for the heap search
+//
+// naiveFindRun() applies the placement rules of heapFindRun() by testing one
+// subregion at a time, with no word tricks, so the two can be compared on
+// random free maps. It is shared by "bench heap" on the target and by the host
+// test in tests/heap_test.c, together with the generators of random maps and
+// request sizes.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "heap.h"
+#include "heapref.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: naiveFitRun()
+* reference for the heap search: shortest free run of subregions first..last-1 holding n,
+* found by testing one subregion at a time; runs end at MPU regions unless span is set
+*/
+static uint8_t naiveFitRun(uint64_t freeMap, uint8_t first, uint8_t last, uint32_t n, bool span, uint8_t *length)
+{
+    uint8_t i = first, start, run, best = 32;
+
+    *length = 32 + 1;
+    while (i < last)
+    {
+        if (!((freeMap >> i) & 1))
+        {
+            i++;
+            continue;
+        }
+        start = i++;
+        while (i < last && ((freeMap >> i) & 1) && (span || (i - first) % HEAP_REGION_SUBREGIONS))
+            i++;
+        run = i - start;
+        if (run >= n && run < *length)
+        {
+            best = start - first;
+            *length = run;
+        }
+    }
+    return best;
+}
+
+/*
+* Function: naiveAlignedRun()
+* reference for aligned blocks: lowest free run of n subregions of the given size whose
+* address is a multiple of the block size, with base the address of subregion first
+*/
+static uint8_t naiveAlignedRun(uint64_t freeMap, uint8_t first, uint8_t last, uint32_t n, bool span,
+                               uint32_t base, uint32_t subregion)
+{
+    uint8_t start, i;
+
+    for (start = 0; first + start + n <= last; start++)
+    {
+        if ((base + start * subregion) % (n * subregion))
+            continue;
+        if (!span && start / HEAP_REGION_SUBREGIONS != (start + n - 1) / HEAP_REGION_SUBREGIONS)
+            continue;
+        for (i = 0; i < n && ((freeMap >> (first + start + i)) & 1); i++);
+        if (i == n)
+            return start;
+    }
+    return 32;
+}
+
+/*
+* Function: naiveFindRun()
+* reference for heapFindRun() with the same placement rules
+*/
+uint8_t naiveFindRun(uint64_t freeMap, uint32_t size, uint8_t flags, uint8_t *count)
+{
+    uint32_t smallN = (size + HEAP_SMALL_SIZE - 1) / HEAP_SMALL_SIZE;
+    uint32_t largeN = (size + HEAP_LARGE_SIZE - 1) / HEAP_LARGE_SIZE;
+    uint8_t smallStart, largeStart, smallRun, largeRun, top, bottom;
+
+    if (size == 0 || size > HEAP_BYTES)
+        return HEAP_SUBREGIONS;
+
+    if (flags & HEAP_ALIGNED)
+    {
+        for (smallN = 1; smallN * HEAP_SMALL_SIZE < size; smallN <<= 1);
+        for (largeN = 1; largeN * HEAP_LARGE_SIZE < size; largeN <<= 1);
+        smallStart = naiveAlignedRun(freeMap, 0, HEAP_SMALL_SUBREGIONS, smallN, flags & HEAP_SPAN_REGIONS,
+                                     HEAP_BASE, HEAP_SMALL_SIZE);
+        largeStart = naiveAlignedRun(freeMap, HEAP_SMALL_SUBREGIONS, HEAP_SUBREGIONS, largeN, true,
+                                     HEAP_LARGE_BASE, HEAP_LARGE_SIZE);
+        if (smallStart < 32)
+        {
+            *count = smallN;
+            return smallStart;
+        }
+        if (largeStart < 32)
+        {
+            *count = largeN;
+            return HEAP_SMALL_SUBREGIONS + largeStart;
+        }
+        return HEAP_SUBREGIONS;
+    }
+
+    smallStart = naiveFitRun(freeMap, 0, HEAP_SMALL_SUBREGIONS, smallN, flags & HEAP_SPAN_REGIONS, &smallRun);
+    largeStart = naiveFitRun(freeMap, HEAP_SMALL_SUBREGIONS, HEAP_SUBREGIONS, largeN, true, &largeRun);
+    if (smallStart < 32 && (largeStart == 32 ||
+        smallRun * HEAP_SMALL_SIZE - size <= largeRun * HEAP_LARGE_SIZE - size))
+    {
+        *count = smallN;
+        return smallStart;
+    }
+    if (largeStart < 32)
+    {
+        *count = largeN;
+        return HEAP_SMALL_SUBREGIONS + largeStart;
+    }
+
+    if (!(flags & HEAP_SPAN_REGIONS))
+        return HEAP_SUBREGIONS;
+    for (top = 0; top < HEAP_SMALL_SUBREGIONS && ((freeMap >> (HEAP_SMALL_SUBREGIONS - 1 - top)) & 1); top++);
+    for (bottom = 0; HEAP_SMALL_SUBREGIONS + bottom < HEAP_SUBREGIONS && ((freeMap >> (HEAP_SMALL_SUBREGIONS + bottom)) & 1); bottom++);
+    for (largeN = 1; largeN <= bottom; largeN++)
+    {
+        for (smallN = 1; smallN <= top; smallN++)
+            if (smallN * HEAP_SMALL_SIZE + largeN * HEAP_LARGE_SIZE >= size)
+            {
+                *count = smallN + largeN;
+                return HEAP_SMALL_SUBREGIONS - smallN;
+            }
+    }
+    return HEAP_SUBREGIONS;
+}
+
+/*
+* Function: randomFreeMap()
+* pseudo-random heap free map, runs of free and used subregions of random length
+* one map in eight allows runs as long as the heap, so nearly empty heaps are covered too
+*/
+uint64_t randomFreeMap(uint32_t *seed)
+{
+    uint64_t freeMap = 0;
+    uint8_t i = 0, run, longest;
+    bool free;
+
+    *seed = *seed * 1664525 + 1013904223;
+    longest = (*seed >> 20) & 7 ? 12 : HEAP_SUBREGIONS;
+    free = (*seed >> 24) & 1;
+    while (i < HEAP_SUBREGIONS)
+    {
+        *seed = *seed * 1664525 + 1013904223;
+        run = (*seed >> 24) % longest + 1;
+        for (; run && i < HEAP_SUBREGIONS; run--, i++)
+            if (free)
+                freeMap |= 1ULL << i;
+        free = !free;
+    }
+    return freeMap;
+}
+
+/*
+* Function: randomHeapSize()
+* pseudo-random request size, mostly stack sized with some up to the whole heap
+*/
+uint32_t randomHeapSize(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    if ((*seed >> 28) == 0)
+        return (*seed >> 8) % HEAP_BYTES + 1;
+    return (*seed >> 8) % (4 * HEAP_LARGE_SIZE) + 1;
+}
@@ -0,0 +1,21 @@
+/*
+ *      Filename: heapref.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef HEAPREF_H_
+#define HEAPREF_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Heap Reference Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+uint8_t naiveFindRun(uint64_t freeMap, uint32_t size, uint8_t flags, uint8_t *count);
+uint64_t randomFreeMap(uint32_t *seed);
+uint32_t randomHeapSize(uint32_t *seed);
+
+#endif
@@ -5,8 +5,10 @@
  *      Author: Abhishek Dhital
  */
 
+#include <stdbool.h>
 #include "tm4c123gh6pm.h"
 #include "isr.h"
+#include "kernel.h"
 #include "mpu.h"
 #include "uart0.h"
 #include "terminal.h"
@@ -82,8 +84,22 @@ void hardFaultISR()
 
 void mpuFaultISR()
 {
-    putsUart0("MPU fault in process N\n\r");
     uint32_t address;
+    char pidStr[MAX_INT_STR_LENGTH + 1];
+
+    // a data access to a window the task declared but that is not loaded: load it and retry
+    if ((NVIC_FAULT_STAT_R & (NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_MMARV)) == (NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_MMARV) &&
+        taskCurrent && faultInMpuWindow(&taskCurrent->windows, NVIC_MM_ADDR_R))
+    {
+        NVIC_FAULT_STAT_R = NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_MMARV;
+        return;
+    }
+
+    putsUart0("MPU fault in process ");
+    putsUart0(integerToAlphabet(taskCurrent->pid, pidStr));
+    putsUart0(" (");
+    putsUart0(taskCurrent->name);
+    putsUart0(")\n\r");
     
     // print MSP
     address = getMSPaddress();
@@ -112,21 +128,11 @@ void mpuFaultISR()
 
     // clear the MPU fault pending bit
     NVIC_SYS_HND_CTRL_R  &= ~NVIC_SYS_HND_CTRL_MEMP;
+    NVIC_FAULT_STAT_R = NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_IERR | NVIC_FAULT_STAT_MMARV;   // clear the DERR, IERR and MMARV bits by writing 1
 
-    // trigger a pendSV ISR call
-    NVIC_INT_CTRL_R |= NVIC_INT_CTRL_ISR_PEND;
-}
-
-void pendSvISR()
-{
-    putsUart0("PendSV in process N\n\r");
-
-    // if the DERR or IERR bits are set, it means pendsv was called by MPU Fault handler
-    if ((NVIC_FAULT_STAT_R & NVIC_FAULT_STAT_DERR) || (NVIC_FAULT_STAT_R & NVIC_FAULT_STAT_IERR))
-    {
-        putsUart("Called From MPU");
-        NVIC_FAULT_STAT_R |= NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_IERR;       // clear the DERR and IERR bits by writing 1
-    }
+    // the faulting process is stopped, pendSV switches to the next ready process and the idle task reclaims it
+    stopCurrentThread();
+    yield();
 }
 
 // enables the specific faults by setting bits in the NVIC_SYS_HND_CTRL_R
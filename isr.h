@@ -14,7 +14,7 @@ void busFaultISR(void);
 void usageFaultISR(void);
 void hardFaultISR(void);
 void mpuFaultISR(void);
-void pendSvISR(void);
+void pendSvISR(void);                   // implemented in kernel_s.s
 void showStackDump(uint32_t *);
 void enableFaults(void);
 
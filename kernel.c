@@ -0,0 +1,1512 @@
+/*
+ *      Filename: kernel.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Preemptive/cooperative task kernel
+//
+// Every thread runs in thread mode on its own process stack (PSP) while
+// exceptions keep using the main stack (MSP). Kernel threads (shell, idle,
+// timer service) run privileged; user programs run unprivileged and reach the
+// kernel only through the SVC gate (syscall.c), so with MPU isolation on they
+// touch nothing but their own subregions and declared windows.
+//
+// Context switch (pendSvISR in kernel_s.s):
+//   the hardware stacks xPSR, PC, LR, R12, R3-R0 on the PSP on exception entry,
+//   pendSvISR pushes R4-R11 and EXC_RETURN below that frame, hands the PSP to
+//   taskSwitch(), and pops the context of the task returned by the scheduler.
+//
+//   Tasks that used the FPU get an extended hardware frame (S0-S15, FPSCR, with
+//   lazy stacking) and pendSvISR adds S16-S31; integer-only tasks pay for neither.
+//
+//                  process stack of a switched-out task
+//                  ------------------------------------
+//                  | xPSR       |  <- highest address
+//                  | PC         |
+//                  | LR         |
+//                  | R12        |
+//                  | R3         |
+//                  | R2         |
+//                  | R1         |
+//                  | R0         |
+//                  | (S16-S31)  |  only for FP tasks
+//                  | EXC_RETURN |
+//                  | R11        |
+//                  | ...        |
+//                  | R4         |  <- tcb[i].sp
+//                  --------------
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tm4c123gh6pm.h"
+#include "kernel.h"
+#include "mpu.h"
+#include "eventflags.h"
+#include "heap.h"
+#include "mutex.h"
+#include "msgqueue.h"
+#include "shmem.h"
+#include "registry.h"
+#include "syscall.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+TCB tcb[MAX_TASKS];
+SLAB taskPool = SLAB_INIT("tasks", tcb, TCB, next);
+TCB *taskCurrent = 0;
+READY_QUEUE readyQueue;
+
+volatile uint32_t kernelTicks = 0;
+
+static schedMode schedulerMode = SCHED_PRIO;
+static bool preemption = true;
+static uint32_t tickRate = DEFAULT_TICK_HZ;
+static bool tickless = true;
+static bool mpuIsolation = false;
+IDLE_STATS idleStats;
+
+// timing wheel: level L slot i holds the timers due within the 32^L ticks that start
+// when bits 5L+4..5L of the tick count equal i; bit (31 - i) of wheelBitmap[L] is set
+// while that slot is non-empty. wheelTick trails kernelTicks until advanceWheel() runs
+static TIMER *wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t wheelBitmap[WHEEL_LEVELS];
+static uint32_t wheelTick = 0;
+
+// ready tasks with a deadline in EDF mode, binary min-heap on the absolute deadline
+static TCB *edfHeap[MAX_TASKS];
+static uint8_t edfCount = 0;
+
+// CPU accounting: the running task is charged the cycles since switchStamp, minus the
+// interrupt time accrued since isrStamp; the tick folds the counts into the idle buffer
+// of cpuSnapshot every CPU_WINDOW_MS and flips cpuSnapshotIndex to it
+volatile uint32_t isrCycles = 0;
+static uint32_t switchStamp = 0;
+static uint32_t isrStamp = 0;
+static uint32_t windowStart = 0;
+static uint32_t windowIsrStart = 0;
+static uint32_t nextFold = 0;
+static uint32_t windowSleepCycles = 0;
+static CPU_SNAPSHOT cpuSnapshot[2];
+static volatile uint8_t cpuSnapshotIndex = 0;
+
+static uint32_t nextPid = 1;
+
+// throw-away process stack used by startRtos() until the first switch, sized for the worst
+// case first PendSV: yield()'s own push, a 104 byte FP hardware frame, S16-S31 (64 bytes)
+// and R4-R11 + EXC_RETURN (36 bytes), 8 byte aligned
+#define BOOT_STACK_DWORDS       32
+static uint64_t bootStack[BOOT_STACK_DWORDS];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: readyQueueInsert()
+* appends the task to the tail of the ready list of the given level
+*/
+void readyQueueInsert(READY_QUEUE *rq, TCB *task, uint8_t level)
+{
+    TCB *head = rq->head[level];
+
+    task->readyLevel = level;
+    if (head == 0)
+    {
+        task->next = task;
+        task->prev = task;
+        rq->head[level] = task;
+        rq->bitmap |= 0x80000000 >> level;
+    }
+    else
+    {
+        // the list is circular, so the tail sits right before the head
+        task->next = head;
+        task->prev = head->prev;
+        head->prev->next = task;
+        head->prev = task;
+    }
+}
+
+/*
+* Function: readyQueueRemove()
+* unlinks the task from its ready list
+*/
+void readyQueueRemove(READY_QUEUE *rq, TCB *task)
+{
+    uint8_t level = task->readyLevel;
+
+    if (task->next == task)
+    {
+        rq->head[level] = 0;
+        rq->bitmap &= ~(0x80000000 >> level);
+    }
+    else
+    {
+        task->prev->next = task->next;
+        task->next->prev = task->prev;
+        if (rq->head[level] == task)
+            rq->head[level] = task->next;
+    }
+    task->next = 0;
+    task->prev = 0;
+}
+
+/*
+* Function: readyQueuePeek()
+* returns the head of the highest priority non-empty ready list, independent of the number of ready tasks
+* returns 0 if every list is empty (CLZ(0) would index past the last level)
+*/
+TCB *readyQueuePeek(READY_QUEUE *rq)
+{
+    if (rq->bitmap == 0)
+        return 0;
+    return rq->head[CLZ(rq->bitmap)];
+}
+
+/*
+* Function: deadlineBefore()
+* true if deadline a is earlier than deadline b, correct across a wrap of the tick counter
+*/
+static bool deadlineBefore(uint32_t a, uint32_t b)
+{
+    return (int32_t) (a - b) < 0;
+}
+
+/*
+* Function: edfHeapSwap()
+* swaps two heap entries and keeps their back-references current
+*/
+static void edfHeapSwap(uint8_t i, uint8_t j)
+{
+    TCB *t = edfHeap[i];
+    edfHeap[i] = edfHeap[j];
+    edfHeap[j] = t;
+    edfHeap[i]->heapIndex = i;
+    edfHeap[j]->heapIndex = j;
+}
+
+/*
+* Function: edfHeapSiftUp()
+* moves an entry towards the root while its deadline is earlier than its parent's
+*/
+static void edfHeapSiftUp(uint8_t i)
+{
+    while (i > 0 && deadlineBefore(edfHeap[i]->absDeadline, edfHeap[(i - 1) / 2]->absDeadline))
+    {
+        edfHeapSwap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+/*
+* Function: edfHeapSiftDown()
+* moves an entry towards the leaves while a child has an earlier deadline
+*/
+static void edfHeapSiftDown(uint8_t i)
+{
+    uint8_t child;
+
+    while ((child = 2 * i + 1) < edfCount)
+    {
+        if (child + 1 < edfCount && deadlineBefore(edfHeap[child + 1]->absDeadline, edfHeap[child]->absDeadline))
+            child++;
+        if (!deadlineBefore(edfHeap[child]->absDeadline, edfHeap[i]->absDeadline))
+            break;
+        edfHeapSwap(i, child);
+        i = child;
+    }
+}
+
+/*
+* Function: edfHeapInsert()
+* adds a task to the deadline heap, O(log n)
+*/
+static void edfHeapInsert(TCB *task)
+{
+    task->readyLevel = EDF_LEVEL;
+    task->heapIndex = edfCount;
+    edfHeap[edfCount++] = task;
+    edfHeapSiftUp(task->heapIndex);
+}
+
+/*
+* Function: edfHeapRemove()
+* removes any task from the deadline heap, O(log n)
+*/
+static void edfHeapRemove(TCB *task)
+{
+    uint8_t i = task->heapIndex;
+
+    edfCount--;
+    if (i != edfCount)
+    {
+        edfHeapSwap(i, edfCount);
+        edfHeapSiftDown(i);
+        edfHeapSiftUp(i);
+    }
+}
+
+/*
+* Function: readyLevelOf()
+* ready list a task belongs on in the current scheduler mode
+*/
+static uint8_t readyLevelOf(TCB *task)
+{
+    if (schedulerMode == SCHED_EDF && task->relDeadline)
+        return EDF_LEVEL;
+    return schedulerMode == SCHED_RR ? RR_LEVEL : task->priority;
+}
+
+/*
+* Function: enqueueReady()
+* adds a task to the ready structure of the current mode (deadline heap or ready lists)
+*/
+static void enqueueReady(TCB *task)
+{
+    uint8_t level = readyLevelOf(task);
+
+    if (level == EDF_LEVEL)
+        edfHeapInsert(task);
+    else
+        readyQueueInsert(&readyQueue, task, level);
+}
+
+/*
+* Function: dequeueReady()
+* removes a task from whichever ready structure holds it
+*/
+static void dequeueReady(TCB *task)
+{
+    if (task->readyLevel == EDF_LEVEL)
+        edfHeapRemove(task);
+    else
+        readyQueueRemove(&readyQueue, task);
+}
+
+/*
+* Function: outranks()
+* true if ready task a should run before task b
+* deadline tasks come before all others in EDF mode, then the earlier deadline wins
+*/
+static bool outranks(TCB *a, TCB *b)
+{
+    if (a->readyLevel == EDF_LEVEL)
+        return b->readyLevel != EDF_LEVEL || deadlineBefore(a->absDeadline, b->absDeadline);
+    return b->readyLevel != EDF_LEVEL && a->readyLevel < b->readyLevel;
+}
+
+/*
+* Function: makeReady()
+* moves a woken task into the ready structure without pending a switch, for callers
+* inside taskSwitch() where the scheduler is about to pick the next task anyway
+* must be called with interrupts disabled
+*/
+void makeReady(TCB *task)
+{
+    // a sporadic task starts a new job each time it is released after completing the last one
+    if (task->relDeadline && task->period == 0 && !task->jobActive)
+    {
+        task->absDeadline = kernelTicks + task->relDeadline;
+        task->jobActive = true;
+    }
+
+    // a task woken before its timeout leaves the wheel too
+    if (task->timeout.slot != TIMER_IDLE)
+        wheelRemove(&task->timeout);
+
+    task->waitQueue = 0;
+    task->blockedOn = 0;
+    task->state = STATE_READY;
+    enqueueReady(task);
+}
+
+/*
+* Function: readyTask()
+* makes a task ready and pends a switch if it outranks the running task under preemption
+* must be called with interrupts disabled
+*/
+void readyTask(TCB *task)
+{
+    makeReady(task);
+    if (preemption && taskCurrent && (taskCurrent->state != STATE_READY || outranks(task, taskCurrent)))
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+}
+
+/*
+* Function: wheelFile()
+* links a timer into the slot for the given tick: the lowest level whose span reaches it
+*/
+static void wheelFile(TIMER *timer, uint32_t position)
+{
+    uint32_t delta = position - wheelTick;
+    uint8_t level = 0, index;
+
+    // beyond the reach of the wheel, park on the top level and get re-filed when cascaded
+    if (delta >= (1UL << (WHEEL_LEVELS * WHEEL_SLOT_BITS)))
+    {
+        delta = (1UL << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1;
+        position = wheelTick + delta;
+    }
+
+    while (level < WHEEL_LEVELS - 1 && delta >= (1UL << ((level + 1) * WHEEL_SLOT_BITS)))
+        level++;
+    index = (position >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1);
+
+    timer->slot = level * WHEEL_SLOTS + index;
+    timer->prev = 0;
+    timer->next = wheel[level][index];
+    if (timer->next)
+        timer->next->prev = timer;
+    wheel[level][index] = timer;
+    wheelBitmap[level] |= 0x80000000 >> index;
+}
+
+/*
+* Function: wheelInsert()
+* arms a timer to expire at the given kernel tick, a tick already gone expires on the next one, O(1)
+* must be called with interrupts disabled
+*/
+void wheelInsert(TIMER *timer, uint32_t expires)
+{
+    timer->expires = expires;
+    wheelFile(timer, (int32_t) (expires - wheelTick) > 0 ? expires : wheelTick + 1);
+}
+
+/*
+* Function: wheelRemove()
+* disarms a timer, O(1)
+* must be called with interrupts disabled
+*/
+void wheelRemove(TIMER *timer)
+{
+    uint8_t level = timer->slot / WHEEL_SLOTS;
+    uint8_t index = timer->slot % WHEEL_SLOTS;
+
+    if (timer->slot == TIMER_IDLE)
+        return;
+
+    if (timer->prev)
+        timer->prev->next = timer->next;
+    else
+        wheel[level][index] = timer->next;
+    if (timer->next)
+        timer->next->prev = timer->prev;
+    if (wheel[level][index] == 0)
+        wheelBitmap[level] &= ~(0x80000000 >> index);
+    timer->next = 0;
+    timer->prev = 0;
+    timer->slot = TIMER_IDLE;
+}
+
+/*
+* Function: slotDistance()
+* number of slots (1-32) from slot index to the next non-empty slot in a level bitmap
+*/
+static uint32_t slotDistance(uint32_t bitmap, uint8_t index)
+{
+    uint8_t shift = (index + 1) & (WHEEL_SLOTS - 1);
+
+    // rotate so that the slot after index lands on bit 31
+    if (shift)
+        bitmap = (bitmap << shift) | (bitmap >> (32 - shift));
+    return CLZ(bitmap) + 1;
+}
+
+/*
+* Function: ticksToNextDeadline()
+* ticks until the wheel next has work to do, 0xFFFFFFFF if nothing is armed
+* level 0 gives the exact expiry, higher levels the tick their next slot is cascaded
+*/
+static uint32_t ticksToNextDeadline(void)
+{
+    uint32_t ticks = 0xFFFFFFFF;
+    uint32_t start, candidate;
+    uint8_t level, shift;
+
+    for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+        if (wheelBitmap[level] == 0)
+            continue;
+        shift = level * WHEEL_SLOT_BITS;
+        start = (wheelTick >> shift) << shift;
+        candidate = start + (slotDistance(wheelBitmap[level], (wheelTick >> shift) & (WHEEL_SLOTS - 1)) << shift)
+                    - kernelTicks;
+        if ((int32_t) candidate < 0)
+            candidate = 0;
+        if (candidate < ticks)
+            ticks = candidate;
+    }
+    return ticks;
+}
+
+/*
+* Function: cascade()
+* re-files the timers of the current slot of a level into the lower levels
+*/
+static void cascade(uint8_t level)
+{
+    uint8_t index = (wheelTick >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1);
+    TIMER *timer;
+
+    while ((timer = wheel[level][index]) != 0)
+    {
+        wheelRemove(timer);
+        wheelFile(timer, timer->expires);
+    }
+}
+
+/*
+* Function: advanceWheel()
+* moves the wheel up to kernelTicks, cascading higher levels at their boundaries and
+* expiring the level 0 slot of every tick; runs of empty level 0 slots are skipped
+*/
+static void advanceWheel(void)
+{
+    TIMER *timer;
+    uint32_t step;
+    uint8_t level, index;
+
+    while (wheelTick != kernelTicks)
+    {
+        if (wheelBitmap[0] == 0)
+        {
+            step = WHEEL_SLOTS - (wheelTick & (WHEEL_SLOTS - 1));
+            if (kernelTicks - wheelTick < step)
+            {
+                wheelTick = kernelTicks;
+                break;
+            }
+            wheelTick += step;
+        }
+        else
+            wheelTick++;
+
+        for (level = 1; level < WHEEL_LEVELS; level++)
+        {
+            if (((wheelTick >> ((level - 1) * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1)) != 0)
+                break;
+            cascade(level);
+        }
+
+        index = wheelTick & (WHEEL_SLOTS - 1);
+        while ((timer = wheel[0][index]) != 0)
+        {
+            wheelRemove(timer);
+            timer->expire(timer);
+        }
+    }
+}
+
+/*
+* Function: taskTimeout()
+* timer expiry of a task: ends its sleep, or its timed block with timedOut set
+*/
+static void taskTimeout(TIMER *timer)
+{
+    TCB *task = timer->owner;
+
+    if (task->state == STATE_BLOCKED)
+    {
+        waitQueueRemove(task->waitQueue, task);
+        task->timedOut = true;
+    }
+    readyTask(task);
+}
+
+/*
+* Function: startSysTick()
+* (re)starts SysTick with the first period given in cycles, later periods use the tick rate
+*/
+static void startSysTick(uint32_t firstCycles)
+{
+    NVIC_ST_RELOAD_R = firstCycles - 1;
+    NVIC_ST_CURRENT_R = 0;                              // any write clears the counter
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN | NVIC_ST_CTRL_ENABLE;
+    NVIC_ST_RELOAD_R = SYSTEM_CLOCK_HZ / tickRate - 1;  // picked up at the next wrap
+}
+
+/*
+* Function: idleSleep()
+* tickless idle: with only the idle task ready, SysTick is stretched to expire at the
+* next deadline, the core sleeps in WFI and the skipped ticks are added on wakeup
+*/
+static void idleSleep(void)
+{
+    uint32_t cyclesPerTick = SYSTEM_CLOCK_HZ / tickRate;
+    uint32_t ticks, entryCurrent, load, ctrl, current, elapsed, slept, remaining, sleptCycles;
+    uint32_t irqState = _disable_interrupts();
+
+    ticks = ticksToNextDeadline();
+    if (ticks > NVIC_ST_RELOAD_M / cyclesPerTick)
+        ticks = NVIC_ST_RELOAD_M / cyclesPerTick;
+
+    // a tick already pending or due is cheaper to take normally
+    if (ticks < 2 || (NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET))
+    {
+        __asm("    WFI");
+        _restore_interrupts(irqState);
+        return;
+    }
+
+    // stop the tick and program one period ending on the tick boundary of the deadline
+    entryCurrent = NVIC_ST_CURRENT_R;                   // cycles left in the running tick
+    NVIC_ST_CTRL_R = 0;
+    load = entryCurrent + (ticks - 1) * cyclesPerTick;
+    NVIC_ST_RELOAD_R = load - 1;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN | NVIC_ST_CTRL_ENABLE;
+
+    // interrupts stay masked, WFI still returns as soon as one is pending
+    __asm("    WFI");
+
+    ctrl = NVIC_ST_CTRL_R;                              // reading clears the COUNT flag
+    current = NVIC_ST_CURRENT_R;
+    NVIC_ST_CTRL_R = 0;
+
+    if (ctrl & NVIC_ST_CTRL_COUNT)
+    {
+        // slept until the deadline, the pending SysTick interrupt accounts for the last tick
+        elapsed = (load - 1) - current;                 // cycles since the counter reloaded
+        slept = ticks - 1 + elapsed / cyclesPerTick;
+        remaining = cyclesPerTick - elapsed % cyclesPerTick;
+        sleptCycles = load + elapsed;
+    }
+    else
+    {
+        // woken early by another interrupt, count the tick boundaries that went by
+        elapsed = (load - 1) - current;
+        if (elapsed < entryCurrent)
+        {
+            slept = 0;
+            remaining = entryCurrent - elapsed;
+        }
+        else
+        {
+            slept = 1 + (elapsed - entryCurrent) / cyclesPerTick;
+            remaining = cyclesPerTick - (elapsed - entryCurrent) % cyclesPerTick;
+        }
+        sleptCycles = elapsed;
+    }
+
+    // the cycle counter stops while the core sleeps, the idle task is charged the time here
+    idleStats.sleepCycles += sleptCycles;
+    taskCurrent->cycles += sleptCycles;
+    windowSleepCycles += sleptCycles;
+
+    startSysTick(remaining > 1 ? remaining : 2);
+    kernelTicks += slept;
+    idleStats.avoidedWakeups += slept;
+    advanceWheel();
+
+    _restore_interrupts(irqState);
+}
+
+/*
+* Function: threadExit()
+* the initial LR of every privileged thread, so a thread that returns from its entry function is stopped cleanly
+*/
+static void threadExit(void)
+{
+    stopCurrentThread();
+    while (1)
+        yield();
+}
+
+/*
+* Function: userThreadExit()
+* the initial LR of an unprivileged thread, which can stop itself only through the SVC gate
+*/
+static void userThreadExit(void)
+{
+    while (1)
+        svcExit();
+}
+
+/*
+* Function: initStackFrame()
+* builds the frame pendSvISR expects to find on a switched-out task
+* and returns the resulting stack pointer
+*/
+static uint32_t *initStackFrame(uint32_t *top, _fn fn, _fn exit)
+{
+    uint8_t i;
+
+    // hardware frame, popped on exception return
+    *(--top) = XPSR_THUMB;              // xPSR
+    *(--top) = (uint32_t) fn;           // PC
+    *(--top) = (uint32_t) exit;         // LR
+    for (i = 0; i < 5; i++)
+        *(--top) = 0;                   // R12, R3, R2, R1, R0
+
+    // software frame, popped by pendSvISR
+    *(--top) = EXC_RETURN_THREAD_PSP;   // new tasks start without an FP context
+    for (i = 0; i < 8; i++)
+        *(--top) = 0;                   // R11-R4
+
+    return top;
+}
+
+/*
+* Function: idle()
+* lowest priority thread, always ready so the scheduler always has something to run
+* it also reclaims tasks that stopped themselves, a stopped task never runs again so
+* its TCB, stack and objects can be taken back from here
+*/
+static void idle(void)
+{
+    uint8_t scan = 0;
+
+    while (1)
+    {
+        // reclaim or refresh the stack high-water mark of one task per pass
+        if (tcb[scan].state == STATE_STOPPED)
+            killThread(tcb[scan].pid);
+        else if (tcb[scan].state != STATE_INVALID)
+            stackHighWater(&tcb[scan]);
+        scan = (scan + 1) % MAX_TASKS;
+
+        // sleep only when nothing else shares the processor
+        if (edfCount == 0 && readyQueuePeek(&readyQueue) == taskCurrent && taskCurrent->next == taskCurrent)
+        {
+            if (tickless)
+                idleSleep();
+            else
+                __asm("    WFI");
+        }
+        yield();
+    }
+}
+
+/*
+* Function: initRtos()
+* clears the task table
+*/
+void initRtos(void)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        tcb[i].state = STATE_INVALID;
+        tcb[i].pid = 0;
+    }
+    for (i = 0; i < NUM_PRIORITIES; i++)
+        readyQueue.head[i] = 0;
+    readyQueue.bitmap = 0;
+    taskCurrent = 0;
+
+    // lazy FP state preservation: an extended frame is reserved only while a task has an
+    // active FP context, and S0-S15 are written only if the handler itself uses the FPU
+    NVIC_FPCC_R |= NVIC_FPCC_ASPEN | NVIC_FPCC_LSPEN;
+
+    // start the DWT cycle counter, used for time measurements
+    CORE_DEMCR_R |= CORE_DEMCR_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+}
+
+/*
+* Function: createTask()
+* adds a thread to the task table with its own process stack and, if windowSize is not 0,
+* a read-write MPU window declared before it first runs
+* returns the pid of the new thread, or 0 if no TCB or stack memory is left or the window is invalid
+*/
+static uint32_t createTask(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes, bool privileged,
+                           uint32_t windowBase, uint32_t windowSize)
+{
+    bool window = true;
+    uint8_t i;
+    uint32_t j;
+    uint32_t *stack;
+    uint32_t irqState;
+    TCB *task;
+
+    irqState = _disable_interrupts();
+    task = slabAlloc(&taskPool);
+    _restore_interrupts(irqState);
+    if (task == 0)
+        return 0;
+    i = slabIndex(&taskPool, task);
+
+    // the stack is a heap block owned by the task, which also opens it in the task's access mask
+    if (stackBytes < MIN_STACK_BYTES)
+        stackBytes = MIN_STACK_BYTES;
+    tcb[i].pid = nextPid;
+    tcb[i].srd = createNoSramAcccessMask();
+    tcb[i].windows.count = 0;
+    if (windowSize)
+        window = addMpuWindow(&tcb[i].windows, windowBase, windowSize, true);
+    stack = window ? heapAllocate(stackBytes, &tcb[i], 0) : 0;
+    if (stack == 0)
+    {
+        irqState = _disable_interrupts();
+        slabFree(&taskPool, task);
+        _restore_interrupts(irqState);
+        return 0;
+    }
+    nextPid++;
+
+    tcb[i].entry = fn;
+    tcb[i].privileged = privileged;
+    tcb[i].priority = priority > LOWEST_PRIORITY ? LOWEST_PRIORITY : priority;
+    tcb[i].basePriority = tcb[i].priority;
+    tcb[i].quantum = DEFAULT_QUANTUM_TICKS;
+    tcb[i].ticksLeft = DEFAULT_QUANTUM_TICKS;
+    tcb[i].timeout.next = 0;
+    tcb[i].timeout.prev = 0;
+    tcb[i].timeout.slot = TIMER_IDLE;
+    tcb[i].timeout.expire = taskTimeout;
+    tcb[i].timeout.owner = &tcb[i];
+    tcb[i].waitNext = 0;
+    tcb[i].waitPrev = 0;
+    tcb[i].waitQueue = 0;
+    tcb[i].blockedOn = 0;
+    tcb[i].waitData = 0;
+    tcb[i].svcResume = 0;
+    tcb[i].ownedMutexes = 0;
+    tcb[i].basepri = 0;
+    tcb[i].joiners = 0;
+    tcb[i].period = 0;
+    tcb[i].relDeadline = 0;
+    tcb[i].deadlineMisses = 0;
+    tcb[i].jobActive = false;
+    tcb[i].stackBase = stack;
+    tcb[i].stackSize = heapBlockSize(stack);
+    tcb[i].stackPeak = 0;
+    tcb[i].cycles = 0;
+    for (j = 0; j < tcb[i].stackSize / sizeof(uint32_t); j++)
+        stack[j] = STACK_PAINT;
+    tcb[i].sp = initStackFrame(stack + tcb[i].stackSize / sizeof(uint32_t), fn, privileged ? threadExit : userThreadExit);
+
+    for (j = 0; j < MAX_TASK_NAME_LENGTH && name[j] != 0; j++)
+        tcb[i].name[j] = name[j];
+    tcb[i].name[j] = 0;
+
+    irqState = _disable_interrupts();
+    registerTask(&tcb[i]);
+    tcb[i].state = STATE_READY;
+    enqueueReady(&tcb[i]);
+    _restore_interrupts(irqState);
+    return tcb[i].pid;
+}
+
+/*
+* Function: createThread()
+* adds a privileged kernel thread, see createTask()
+*/
+uint32_t createThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes)
+{
+    return createTask(fn, name, priority, stackBytes, true, 0, 0);
+}
+
+/*
+* Function: createUserThread()
+* adds an unprivileged thread, which calls the kernel only through the svc stubs (syscall.h)
+* windowSize > 0 grants it a read-write window at windowBase (a peripheral it drives), an
+* unprivileged thread cannot declare windows itself
+*/
+uint32_t createUserThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes,
+                          uint32_t windowBase, uint32_t windowSize)
+{
+    return createTask(fn, name, priority, stackBytes, false, windowBase, windowSize);
+}
+
+/*
+* Function: startRtos()
+* moves thread mode onto the process stack and pends the first switch; never returns
+*/
+void startRtos(void)
+{
+    createThread(idle, "idle", LOWEST_PRIORITY, MIN_STACK_BYTES);
+
+    // PendSV gets the lowest exception priority so it never preempts another handler
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~NVIC_SYS_PRI3_PENDSV_M) | (7 << NVIC_SYS_PRI3_PENDSV_S);
+
+    // kernel tick from SysTick on the system clock
+    setTickRate(tickRate);
+
+    // the context saved by the first PendSV lands in bootStack and is discarded
+    setPSPaddress((uint32_t) &bootStack[BOOT_STACK_DWORDS]);
+    setASPbit();
+
+    yield();
+    while (1);
+}
+
+/*
+* Function: yield()
+* moves the running thread to the tail of its ready list and pends a PendSV
+*/
+void yield(void)
+{
+    uint32_t irqState = _disable_interrupts();
+    TCB *task = taskCurrent;
+
+    // the running task is the head of its list, the next one in line becomes the head
+    // (deadline tasks keep their place in the heap, the deadline alone orders them)
+    if (task && task->state == STATE_READY && task->readyLevel != EDF_LEVEL && readyQueue.head[task->readyLevel] == task)
+        readyQueue.head[task->readyLevel] = task->next;
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    _restore_interrupts(irqState);
+}
+
+/*
+* Function: msToTicks()
+* converts milliseconds to kernel ticks, rounding up
+*/
+uint32_t msToTicks(uint32_t ms)
+{
+    return ((uint64_t) ms * tickRate + 999) / 1000;
+}
+
+/*
+* Function: sleep()
+* delays the running task for at least the given number of milliseconds
+* returns at once while the task holds a BASEPRI ceiling (see blockCurrentTask())
+*/
+void sleep(uint32_t ms)
+{
+    uint32_t ticks = msToTicks(ms);
+    uint32_t irqState;
+
+    if (taskCurrent->basepri)
+        return;
+    if (ticks == 0)
+    {
+        yield();
+        return;
+    }
+
+    irqState = _disable_interrupts();
+    dequeueReady(taskCurrent);
+    taskCurrent->state = STATE_DELAYED;
+    wheelInsert(&taskCurrent->timeout, kernelTicks + ticks);
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    _restore_interrupts(irqState);
+}
+
+/*
+* Function: setThreadDeadline()
+* makes a task a real-time task for EDF scheduling
+* periodMs > 0: periodic task, ends every job with waitNextPeriod()
+* periodMs = 0: sporadic task, every release after a waitNextPeriod() starts a new job
+* deadlineMs = 0 uses the period as the deadline, both 0 makes the task non real-time again
+*/
+bool setThreadDeadline(uint32_t pid, uint32_t periodMs, uint32_t deadlineMs)
+{
+    TCB *task = findTask(pid);
+    uint32_t irqState;
+
+    if (task == 0)
+        return false;
+
+    irqState = _disable_interrupts();
+    if (task->state == STATE_READY)
+        dequeueReady(task);
+
+    task->period = msToTicks(periodMs);
+    task->relDeadline = deadlineMs ? msToTicks(deadlineMs) : task->period;
+    task->releaseTick = kernelTicks;
+    task->absDeadline = kernelTicks + task->relDeadline;
+    task->jobActive = true;
+
+    if (task->state == STATE_READY)
+        enqueueReady(task);
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: waitNextPeriod()
+* ends the current job of a real-time task, counting a miss if it finished late
+* periodic tasks sleep until their next release, sporadic tasks keep running until they block
+* returns at once while the task holds a BASEPRI ceiling (see blockCurrentTask())
+*/
+void waitNextPeriod(void)
+{
+    TCB *task = taskCurrent;
+    uint32_t irqState;
+
+    if (task->basepri)
+        return;
+    if (task->relDeadline == 0)
+    {
+        yield();
+        return;
+    }
+
+    irqState = _disable_interrupts();
+    if (deadlineBefore(task->absDeadline, kernelTicks))
+        task->deadlineMisses++;
+
+    if (task->period == 0)
+        task->jobActive = false;
+    else
+    {
+        task->releaseTick += task->period;
+        dequeueReady(task);
+        task->absDeadline = task->releaseTick + task->relDeadline;
+        if (deadlineBefore(kernelTicks, task->releaseTick))
+        {
+            task->state = STATE_DELAYED;
+            wheelInsert(&task->timeout, task->releaseTick);
+        }
+        else
+            enqueueReady(task);                         // overran, the next job is already released
+    }
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    _restore_interrupts(irqState);
+}
+
+/*
+* Function: findTask()
+* returns the TCB of a live task with the given pid, or 0
+*/
+TCB *findTask(uint32_t pid)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS; i++)
+        if (tcb[i].state != STATE_INVALID && tcb[i].pid == pid)
+            return &tcb[i];
+    return 0;
+}
+
+/*
+* Function: stackHighWater()
+* deepest stack use of a task in bytes: the paint is scanned a word at a time from the
+* far (lowest) end of the stack up to the first word the task has written
+*/
+uint32_t stackHighWater(TCB *task)
+{
+    uint32_t *word = task->stackBase;
+    uint32_t *top = task->stackBase + task->stackSize / sizeof(uint32_t);
+
+    while (word < top && *word == STACK_PAINT)
+        word++;
+    task->stackPeak = (top - word) * sizeof(uint32_t);
+    return task->stackPeak;
+}
+
+/*
+* Function: wakeJoiners()
+* readies every task waiting in joinThread() for a task that has stopped
+* must be called with interrupts disabled
+*/
+static void wakeJoiners(TCB *task)
+{
+    TCB *joiner;
+
+    while ((joiner = task->joiners) != 0)
+    {
+        waitQueueRemove(&task->joiners, joiner);
+        readyTask(joiner);
+    }
+}
+
+/*
+* Function: stopCurrentThread()
+* takes the running thread out of scheduling, the switch happens on the next PendSV
+* used by thread exit, svcExit and the MPU fault handler; none of them may free the
+* stack they are running on, so the idle task later reclaims the task with killThread()
+*/
+void stopCurrentThread(void)
+{
+    uint32_t irqState = _disable_interrupts();
+    if (taskCurrent && taskCurrent->state == STATE_READY)
+    {
+        // a BASEPRI ceiling would mask the switch away, its mutex is released when the task is reclaimed
+        taskCurrent->basepri = 0;
+        _set_interrupt_priority(0);
+        dequeueReady(taskCurrent);
+        taskCurrent->state = STATE_STOPPED;
+        wakeJoiners(taskCurrent);
+    }
+    _restore_interrupts(irqState);
+}
+
+/*
+* Function: joinThread()
+* blocks the caller until the task with the given pid stops or is killed
+* returns false for an unknown pid (also a stopped task the idle task already reclaimed),
+* the caller's own or a caller that may not block
+*/
+bool joinThread(uint32_t pid)
+{
+    TCB *task;
+    uint32_t irqState = _disable_interrupts();
+
+    task = findTask(pid);
+    if (task == 0 || task == taskCurrent)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+    if (task->state != STATE_STOPPED && !blockCurrentTask(&task->joiners, task))
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: killThread()
+* ends another task and takes back everything it holds: it leaves the ready structure,
+* the timing wheel and any wait queue, its mutexes pass to their waiters (owners it was
+* boosting drop back), its heap blocks and stack, message blocks and shared memory
+* attachments are returned, its joiners wake and its TCB goes back to the pool
+* every membership is an intrusive link in the TCB or a bit in its access mask, so the
+* cost is bounded by what the task holds, not by how many objects exist
+* returns false for an unknown pid, the caller itself or the idle task
+*/
+bool killThread(uint32_t pid)
+{
+    TCB *task;
+    uint32_t irqState = _disable_interrupts();
+
+    task = findTask(pid);
+    if (task == 0 || task == taskCurrent || task->entry == idle)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+
+    if (task->state == STATE_READY)
+        dequeueReady(task);
+    wheelRemove(&task->timeout);
+    releaseTaskMutexes(task);
+    if (task->waitQueue)
+        waitQueueRemove(task->waitQueue, task);
+    task->waitQueue = 0;
+    task->blockedOn = 0;
+
+    releaseTaskMessages(task);
+    detachTaskSegments(task->pid);
+    heapReleaseTask(task);
+    wakeJoiners(task);
+
+    unregisterTask(task);
+    task->state = STATE_INVALID;
+    slabFree(&taskPool, task);
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: waitQueueInsert()
+* adds a task to a wait queue ordered by effective priority, FIFO among equal priorities
+*/
+void waitQueueInsert(TCB **head, TCB *task)
+{
+    TCB *prev = 0;
+    TCB *node = *head;
+
+    while (node && node->priority <= task->priority)
+    {
+        prev = node;
+        node = node->waitNext;
+    }
+
+    task->waitPrev = prev;
+    task->waitNext = node;
+    if (node)
+        node->waitPrev = task;
+    if (prev)
+        prev->waitNext = task;
+    else
+        *head = task;
+}
+
+/*
+* Function: waitQueueRemove()
+* unlinks a task from a wait queue
+*/
+void waitQueueRemove(TCB **head, TCB *task)
+{
+    if (task->waitPrev)
+        task->waitPrev->waitNext = task->waitNext;
+    else
+        *head = task->waitNext;
+    if (task->waitNext)
+        task->waitNext->waitPrev = task->waitPrev;
+    task->waitNext = 0;
+    task->waitPrev = 0;
+}
+
+/*
+* Function: blockCurrentTask()
+* moves the running task from the ready queue to a wait queue and pends the switch,
+* which happens once the caller re-enables interrupts
+* refused while the task holds a BASEPRI ceiling, which masks PendSV: the task would keep
+* running while marked blocked; it returns false with taskCurrent->timedOut set, so
+* callers that report timeouts fail the call
+* must be called with interrupts disabled
+*/
+bool blockCurrentTask(TCB **waitQueue, void *object)
+{
+    TCB *task = taskCurrent;
+
+    if (task->basepri)
+    {
+        task->timedOut = true;
+        return false;
+    }
+    dequeueReady(task);
+    task->state = STATE_BLOCKED;
+    task->waitQueue = waitQueue;
+    task->blockedOn = object;
+    task->blockStart = DWT_CYCCNT_R;
+    task->timedOut = false;
+    waitQueueInsert(waitQueue, task);
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    return true;
+}
+
+/*
+* Function: blockCurrentTaskTimeout()
+* blocks the running task like blockCurrentTask(), but readies it again after the given
+* number of ticks if nobody woke it first; taskCurrent->timedOut tells which happened
+* must be called with interrupts disabled
+*/
+void blockCurrentTaskTimeout(TCB **waitQueue, void *object, uint32_t ticks)
+{
+    if (blockCurrentTask(waitQueue, object))
+        wheelInsert(&taskCurrent->timeout, kernelTicks + ticks);
+}
+
+/*
+* Function: setTaskPriority()
+* changes the effective priority of a task, moving it to the matching ready list or
+* to its new place in the wait queue it is blocked on
+* the running task goes to the head of its new list and keeps the processor unless the
+* change leaves a higher priority task ready, so raising it never costs a switch
+* must be called with interrupts disabled
+*/
+void setTaskPriority(TCB *task, uint8_t priority)
+{
+    if (task->priority == priority)
+        return;
+    task->priority = priority;
+
+    if (task->state == STATE_READY && readyLevelOf(task) != task->readyLevel)
+    {
+        dequeueReady(task);
+        enqueueReady(task);
+        if (task != taskCurrent)
+            NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;    // let the scheduler re-evaluate
+        else
+        {
+            if (task->readyLevel != EDF_LEVEL)
+                readyQueue.head[task->readyLevel] = task;
+            if (rtosScheduler() != task)
+                NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+        }
+    }
+    else if (task->state == STATE_BLOCKED && task->waitQueue)
+    {
+        waitQueueRemove(task->waitQueue, task);
+        waitQueueInsert(task->waitQueue, task);
+    }
+}
+
+/*
+* Function: setSchedulerMode()
+* requeues every ready task on the list matching the new mode
+*/
+void setSchedulerMode(schedMode mode)
+{
+    uint8_t i;
+    uint32_t irqState = _disable_interrupts();
+
+    schedulerMode = mode;
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state == STATE_READY)
+        {
+            dequeueReady(&tcb[i]);
+            enqueueReady(&tcb[i]);
+        }
+    }
+    _restore_interrupts(irqState);
+    yield();
+}
+
+schedMode getSchedulerMode(void)
+{
+    return schedulerMode;
+}
+
+/*
+* Function: setPreemption()
+* on:  the tick rotates equal priority tasks when their quantum runs out
+* off: tasks only switch when they call yield()
+*/
+void setPreemption(bool on)
+{
+    preemption = on;
+}
+
+bool getPreemption(void)
+{
+    return preemption;
+}
+
+/*
+* Function: setTickRate()
+* reprograms SysTick for the given tick frequency, returns false if the rate is out of range
+*/
+bool setTickRate(uint32_t hz)
+{
+    uint32_t reload;
+
+    if (hz == 0 || hz > SYSTEM_CLOCK_HZ)
+        return false;
+    reload = SYSTEM_CLOCK_HZ / hz - 1;
+    if (reload == 0 || reload > NVIC_ST_RELOAD_M)       // SysTick is a 24-bit counter
+        return false;
+
+    tickRate = hz;
+    NVIC_ST_CTRL_R = 0;
+    startSysTick(reload + 1);
+    return true;
+}
+
+uint32_t getTickRate(void)
+{
+    return tickRate;
+}
+
+/*
+* Function: setTickless()
+* on:  the idle task suppresses SysTick until the next deadline
+* off: the idle task wakes on every tick
+*/
+void setTickless(bool on)
+{
+    tickless = on;
+}
+
+bool getTickless(void)
+{
+    return tickless;
+}
+
+/*
+* Function: setMpuIsolation()
+* turns MPU isolation on or off, with it on each task only reaches the SRAM subregions in its srd mask
+*/
+void setMpuIsolation(bool on)
+{
+    uint32_t irqState = _disable_interrupts();
+
+    mpuIsolation = on;
+    if (on)
+    {
+        initMPU();
+        if (taskCurrent)
+        {
+            applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+            loadMpuWindows(&taskCurrent->windows);
+        }
+    }
+    else
+        NVIC_MPU_CTRL_R &= ~NVIC_MPU_CTRL_ENABLE;
+    _restore_interrupts(irqState);
+}
+
+bool getMpuIsolation(void)
+{
+    return mpuIsolation;
+}
+
+/*
+* Function: addTaskWindow()
+* declares a memory window for the running task, see addMpuWindow()
+* nothing is loaded here: the first access faults the window in, and later switches pin it if it is hot
+*/
+bool addTaskWindow(uint32_t base, uint32_t size, bool writable)
+{
+    uint32_t irqState = _disable_interrupts();
+    bool ok = addMpuWindow(&taskCurrent->windows, base, size, writable);
+
+    _restore_interrupts(irqState);
+    return ok;
+}
+
+/*
+* Function: removeTaskWindow()
+* drops the running task's window at base
+*/
+bool removeTaskWindow(uint32_t base)
+{
+    uint32_t irqState = _disable_interrupts();
+    bool ok = removeMpuWindow(&taskCurrent->windows, base);
+
+    if (ok && mpuIsolation)
+        loadMpuWindows(&taskCurrent->windows);
+    _restore_interrupts(irqState);
+    return ok;
+}
+
+/*
+* Function: setThreadQuantum()
+* sets the round robin time slice of a task in ticks
+*/
+bool setThreadQuantum(uint32_t pid, uint16_t ticks)
+{
+    TCB *task = findTask(pid);
+
+    if (task == 0 || ticks == 0)
+        return false;
+    task->quantum = ticks;
+    return true;
+}
+
+/*
+* Function: chargeCurrentTask()
+* adds the cycles since the last switch or fold, less interrupt time, to the running task
+* returns the cycle count the charge was taken at
+*/
+static uint32_t chargeCurrentTask(void)
+{
+    // both counters are read together so a handler cannot fall between them
+    uint32_t irqState = _disable_interrupts();
+    uint32_t now = DWT_CYCCNT_R;
+    uint32_t isr = isrCycles;
+
+    if (taskCurrent)
+        taskCurrent->cycles += now - switchStamp - (isr - isrStamp);
+    switchStamp = now;
+    isrStamp = isr;
+    _restore_interrupts(irqState);
+    return now;
+}
+
+/*
+* Function: foldCpuTime()
+* closes the accounting window into the snapshot buffer ps is not reading and publishes it
+*/
+static void foldCpuTime(void)
+{
+    CPU_SNAPSHOT *snapshot = &cpuSnapshot[cpuSnapshotIndex ^ 1];
+    uint32_t now = chargeCurrentTask();
+    uint8_t i;
+
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        snapshot->pid[i] = tcb[i].state == STATE_INVALID ? 0 : tcb[i].pid;
+        snapshot->cycles[i] = tcb[i].cycles;
+        tcb[i].cycles = 0;
+    }
+    snapshot->isrCycles = isrStamp - windowIsrStart;
+    snapshot->totalCycles = now - windowStart + windowSleepCycles;
+    windowSleepCycles = 0;
+    windowStart = now;
+    windowIsrStart = isrStamp;
+    cpuSnapshotIndex ^= 1;
+}
+
+/*
+* Function: getCpuSnapshot()
+* CPU time of the last complete accounting window
+*/
+const CPU_SNAPSHOT *getCpuSnapshot(void)
+{
+    return &cpuSnapshot[cpuSnapshotIndex];
+}
+
+/*
+* Function: systickISR()
+* kernel tick, ends the time slice of the running task when preemption is on
+*/
+void systickISR(void)
+{
+    TCB *task = taskCurrent;
+    uint32_t start = DWT_CYCCNT_R;
+
+    kernelTicks++;
+    advanceWheel();
+
+    if (preemption && task != 0 && task->state == STATE_READY && --task->ticksLeft == 0)
+    {
+        task->ticksLeft = task->quantum;
+
+        // only switch when another task is waiting on the same level
+        if (task->readyLevel != EDF_LEVEL && task->next != task && readyQueue.head[task->readyLevel] == task)
+        {
+            readyQueue.head[task->readyLevel] = task->next;
+            NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+        }
+    }
+    isrCycles += DWT_CYCCNT_R - start;
+
+    // after the tick's own time is in, so the window covers it whole
+    if ((int32_t) (kernelTicks - nextFold) >= 0)
+    {
+        foldCpuTime();
+        nextFold = kernelTicks + msToTicks(CPU_WINDOW_MS);
+    }
+}
+
+/*
+* Function: rtosScheduler()
+* picks the earliest deadline task in EDF mode, otherwise the head of the highest
+* priority non-empty ready list
+*/
+TCB *rtosScheduler(void)
+{
+    if (edfCount)
+        return edfHeap[0];
+    return readyQueuePeek(&readyQueue);
+}
+
+/*
+* Function: taskSwitch()
+* called from pendSvISR with the PSP of the outgoing task (after its software frame was pushed)
+* returns the saved PSP of the incoming task
+*/
+uint32_t *taskSwitch(uint32_t *sp)
+{
+    TCB *next;
+    uint32_t *frame;
+
+    if (taskCurrent)
+        taskCurrent->sp = sp;
+    chargeCurrentTask();
+    wakeEventWaiters();                         // event flags set since the last switch
+    next = rtosScheduler();
+    if (next == 0)
+        next = taskCurrent;                     // nothing ready (only before idle exists), resume the caller
+
+    // a task that is switched in starts a fresh time slice, its privilege level, the BASEPRI of
+    // the ceiling mutexes it holds (handed over while it waited) and its view of SRAM
+    if (next != taskCurrent)
+    {
+        next->ticksLeft = next->quantum;
+        setThreadPrivilege(next->privileged);
+        _set_interrupt_priority(next->basepri);
+        if (mpuIsolation)
+        {
+            applySramRegionTable(&next->mpuTable, next->srd);
+            loadMpuWindows(&next->windows);
+        }
+    }
+    // a system call that blocked learns its outcome now: it goes into the stacked R0, above
+    // R4-R11, EXC_RETURN and, for an FP context, S16-S31
+    if (next->svcResume)
+    {
+        frame = next->sp + 9;
+        if (!(next->sp[8] & EXC_RETURN_BASIC_FRAME))
+            frame += 16;
+        frame[0] = next->svcResume(next);
+        next->svcResume = 0;
+    }
+    taskCurrent = next;
+    return taskCurrent->sp;
+}
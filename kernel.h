@@ -0,0 +1,205 @@
+/*
+ *      Filename: kernel.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "slab.h"
+#include "mpu.h"
+
+//-----------------------------------------------------------------------------
+// Kernel Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_TASK_NAME_LENGTH    15
+#define NUM_PRIORITIES          32          // one ready bitmap bit per priority level
+#define LOWEST_PRIORITY         31          // priority 0 is the highest, 31 the lowest (idle)
+#define RR_LEVEL                0           // ready list shared by all tasks in round robin mode
+#define EDF_LEVEL               0xFF        // readyLevel of a task kept in the EDF deadline heap
+
+#define MIN_STACK_BYTES         512         // stacks are heap blocks, rounded up to whole MPU subregions
+#define STACK_PAINT             0xC5C5C5C5  // fill of unused stack words, for the high-water mark
+
+#define SYSTEM_CLOCK_HZ         40000000
+#define DEFAULT_TICK_HZ         1000        // kernel tick rate, adjustable with setTickRate()
+#define DEFAULT_QUANTUM_TICKS   10          // round robin time slice, adjustable per task
+#define CPU_WINDOW_MS           1000        // CPU time is reported over windows of this length
+
+#define WHEEL_LEVELS            6           // timing wheel: 6 levels of 32 slots cover 2^30 ticks
+#define WHEEL_SLOTS             32
+#define WHEEL_SLOT_BITS         5
+#define TIMER_IDLE              0xFF        // TIMER.slot of a timer that is not armed
+
+#define XPSR_THUMB              0x01000000  // T bit, must be set in the initial stacked xPSR
+#define EXC_RETURN_THREAD_PSP   0xFFFFFFFD  // return to thread mode on the PSP with a basic (non-FP) frame
+#define EXC_RETURN_BASIC_FRAME  0x10        // EXC_RETURN bit 4, clear when S16-S31 follow it on the stack
+
+// count leading zeros (CLZ instruction through the compiler intrinsic)
+#define CLZ(x)                  _norm(x)
+// count trailing zeros of a non-zero word: CLZ of its lowest set bit
+#define CTZ(x)                  (31 - CLZ((x) & -(x)))
+
+/* Data Watchpoint and Trace unit, cycle counter used for timing */
+#define CORE_DEMCR_R            (*((volatile uint32_t *)0xE000EDFC))
+#define CORE_DEMCR_TRCENA       0x01000000  // enables the DWT and ITM units
+#define DWT_CTRL_R              (*((volatile uint32_t *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // enables the cycle counter
+#define DWT_CYCCNT_R            (*((volatile uint32_t *)0xE0001004))
+
+typedef void (*_fn)(void);
+
+// entry of the kernel timing wheel, armed with wheelInsert()
+typedef struct _TIMER
+{
+    struct _TIMER *next;                    // wheel slot links
+    struct _TIMER *prev;
+    uint32_t expires;                       // kernel tick the timer is due
+    uint8_t slot;                           // level * WHEEL_SLOTS + slot, TIMER_IDLE when not armed
+    void (*expire)(struct _TIMER *timer);   // called from the tick interrupt when due
+    void *owner;                            // object the timer belongs to
+} TIMER;
+
+typedef enum _task_state_
+{
+    STATE_INVALID,                          // TCB slot is free
+    STATE_READY,                            // task can be scheduled
+    STATE_DELAYED,                          // task is sleeping until its wake tick
+    STATE_BLOCKED,                          // task is waiting on a kernel object
+    STATE_STOPPED                           // task exited or faulted, the idle task reclaims it
+} taskState;
+
+typedef enum _sched_mode_
+{
+    SCHED_PRIO,                             // highest priority ready task runs, round robin among equals
+    SCHED_RR,                               // all ready tasks share one level regardless of priority
+    SCHED_EDF                               // tasks with a deadline run earliest deadline first,
+                                            // tasks without one run by priority when none is ready
+} schedMode;
+
+typedef struct _TCB
+{
+    uint32_t *sp;                           // saved process stack pointer (points at R4 of the software frame)
+    struct _TCB *next;                      // ready list links (circular, doubly linked)
+    struct _TCB *prev;
+    uint8_t readyLevel;                     // ready list the task is queued on
+    _fn entry;                              // thread entry point
+    bool privileged;                        // runs in privileged thread mode, false for user programs
+    uint32_t pid;                           // process id, unique for the life of the system
+    uint8_t state;                          // one of taskState
+    uint8_t priority;                       // effective priority, 0 highest, LOWEST_PRIORITY lowest
+    uint8_t basePriority;                   // assigned priority, before any inheritance
+    uint16_t quantum;                       // time slice in ticks
+    uint16_t ticksLeft;                     // ticks left in the current time slice
+    TIMER timeout;                          // wakes a delayed task or ends a timed block
+    struct _TCB *waitNext;                  // wait queue links (priority ordered)
+    struct _TCB *waitPrev;
+    struct _TCB **waitQueue;                // head of the wait queue the task is blocked on
+    void *blockedOn;                        // kernel object the task is blocked on
+    uint32_t blockStart;                    // cycle count when the task blocked
+    bool timedOut;                          // the last timed block ended by its timeout
+    void *waitData;                         // value handed to a blocked task by the one that wakes it
+    uint32_t (*svcResume)(struct _TCB *);   // result of a system call that blocked, taken when it runs again
+    void *ownedMutexes;                     // mutexes held by the task (MUTEX list)
+    uint8_t basepri;                        // BASEPRI owed to held ceiling mutexes, loaded by taskSwitch()
+    struct _TCB *joiners;                   // tasks blocked in joinThread() until this one stops
+    uint32_t period;                        // release period in ticks, 0 for sporadic or non real-time tasks
+    uint32_t relDeadline;                   // deadline relative to the release in ticks, 0 if none
+    uint32_t absDeadline;                   // deadline of the current job
+    uint32_t releaseTick;                   // release of the current job (periodic tasks)
+    uint32_t deadlineMisses;                // jobs completed after their deadline
+    uint8_t heapIndex;                      // position in the EDF heap
+    bool jobActive;                         // sporadic tasks: a job was released and has not completed
+    char name[MAX_TASK_NAME_LENGTH + 1];
+    uint32_t nameHash;                      // case insensitive hash of the name (registry.c)
+    uint32_t *stackBase;                    // lowest address of the stack
+    uint32_t stackSize;                     // stack size in bytes
+    uint32_t stackPeak;                     // deepest stack use seen in bytes (high-water mark)
+    uint64_t srd;                           // SRAM subregions the task may access (mpu.c access mask)
+    SRAM_REGION_TABLE mpuTable;             // srd as MPU register words, rebuilt when srd changes
+    MPU_WINDOW_LIST windows;                // memory windows outside its srd mask (mpu.c window cache)
+    uint32_t cycles;                        // CPU cycles run in the current accounting window
+} TCB;
+
+// ready tasks, bitmap bit (31 - level) is set while head[level] is non-empty
+typedef struct _READY_QUEUE
+{
+    uint32_t bitmap;
+    TCB *head[NUM_PRIORITIES];
+} READY_QUEUE;
+
+// tickless idle statistics
+typedef struct _IDLE_STATS
+{
+    uint32_t avoidedWakeups;                // tick interrupts that did not happen while sleeping
+    uint64_t sleepCycles;                   // total time spent in tickless sleep
+} IDLE_STATS;
+
+// CPU time of one accounting window, filled by the tick and read by ps
+typedef struct _CPU_SNAPSHOT
+{
+    uint32_t pid[MAX_TASKS];                // owner of each tcb slot when the window closed
+    uint32_t cycles[MAX_TASKS];             // task time, interrupt handlers excluded
+    uint32_t isrCycles;                     // time in instrumented interrupt handlers
+    uint32_t totalCycles;                   // length of the window
+} CPU_SNAPSHOT;
+
+extern TCB tcb[MAX_TASKS];
+extern SLAB taskPool;
+extern TCB *taskCurrent;
+extern READY_QUEUE readyQueue;
+extern volatile uint32_t kernelTicks;
+extern IDLE_STATS idleStats;
+extern volatile uint32_t isrCycles;
+
+void initRtos(void);
+void startRtos(void);
+uint32_t createThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes);
+uint32_t createUserThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes,
+                          uint32_t windowBase, uint32_t windowSize);
+void yield(void);
+void sleep(uint32_t ms);
+bool setThreadDeadline(uint32_t pid, uint32_t periodMs, uint32_t deadlineMs);
+void waitNextPeriod(void);
+uint32_t msToTicks(uint32_t ms);
+void stopCurrentThread(void);
+bool joinThread(uint32_t pid);
+bool killThread(uint32_t pid);
+void setTaskPriority(TCB *task, uint8_t priority);
+void makeReady(TCB *task);
+void readyTask(TCB *task);
+void wheelInsert(TIMER *timer, uint32_t expires);
+void wheelRemove(TIMER *timer);
+bool blockCurrentTask(TCB **waitQueue, void *object);
+void blockCurrentTaskTimeout(TCB **waitQueue, void *object, uint32_t ticks);
+void waitQueueInsert(TCB **head, TCB *task);
+void waitQueueRemove(TCB **head, TCB *task);
+TCB *findTask(uint32_t pid);
+uint32_t stackHighWater(TCB *task);
+const CPU_SNAPSHOT *getCpuSnapshot(void);
+void setSchedulerMode(schedMode mode);
+schedMode getSchedulerMode(void);
+void readyQueueInsert(READY_QUEUE *rq, TCB *task, uint8_t level);
+void readyQueueRemove(READY_QUEUE *rq, TCB *task);
+TCB *readyQueuePeek(READY_QUEUE *rq);
+void setPreemption(bool on);
+bool getPreemption(void);
+bool setTickRate(uint32_t hz);
+uint32_t getTickRate(void);
+bool setThreadQuantum(uint32_t pid, uint16_t ticks);
+void setTickless(bool on);
+bool getTickless(void);
+void setMpuIsolation(bool on);
+bool getMpuIsolation(void);
+bool addTaskWindow(uint32_t base, uint32_t size, bool writable);
+bool removeTaskWindow(uint32_t base);
+void systickISR(void);
+uint32_t *taskSwitch(uint32_t *sp);
+void clearFpuContext(void);
+TCB *rtosScheduler(void);
+
+#endif
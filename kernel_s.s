@@ -0,0 +1,44 @@
+; Kernel assembly functions
+
+	.def pendSvISR
+	.def clearFpuContext
+	.ref taskSwitch
+
+
+.thumb
+.const
+
+.text
+
+; PendSV handler - saves the context of the running task and restores the next one
+; R4-R11 and EXC_RETURN go on the process stack below the frame stacked by hardware,
+; taskSwitch() stores the outgoing PSP and returns the PSP of the task to resume
+;
+; EXC_RETURN bit 4 is clear only when the task has an active FP context (CONTROL.FPCA),
+; so S16-S31 are saved and restored just for tasks that used the FPU. S0-S15 and FPSCR
+; are left to the lazy stacking of the hardware (FPCCR.LSPEN)
+pendSvISR:
+			MRS		R0, PSP
+			TST		LR, #0x10
+			IT		EQ
+			VSTMDBEQ R0!, {S16-S31}				; push S16-S31 of an FP task
+			STMDB	R0!, {R4-R11, LR}			; push R4-R11 and EXC_RETURN of the outgoing task
+			BL		taskSwitch					; R0 = PSP of the incoming task
+			LDMIA	R0!, {R4-R11, LR}			; pop R4-R11 and EXC_RETURN of the incoming task
+			TST		LR, #0x10
+			IT		EQ
+			VLDMIAEQ R0!, {S16-S31}				; pop S16-S31 of an FP task
+			MSR		PSP, R0
+			BX		LR							; hardware pops the rest of the frame
+
+; drops the FP context of the calling thread (clears CONTROL.FPCA),
+; its next exception uses the basic frame again
+clearFpuContext:
+			MRS		R0, CONTROL
+			BIC		R0, R0, #0x4
+			MSR		CONTROL, R0
+			ISB
+			BX		LR
+
+
+.end
@@ -3,6 +3,9 @@
 #include "uart0.h"
 #include "onboard_leds.h"
 #include "terminal.h"
+#include "kernel.h"
+#include "timer.h"
+#include "tasks.h"
 
 int main()
 {
@@ -11,8 +14,15 @@ int main()
     // initialize the onboard LEDs
     initOnboardLeds();
 
-    // start the shell
-    startShell();
+    // initialize the kernel and add the shell as a thread
+    initRtos();
+    initUart0Rx();
+    initTimerService();
+    initPrograms();
+    createThread(startShell, "shell", 8, 1024);
+
+    // start the kernel, never returns
+    startRtos();
 
     return 0;
 }
@@ -39,35 +39,18 @@
 //                  MPU Model implemented in this code showing all regions
 //  *************************************************************************************
 //  *                                                                                   *
-//  * -1 default region covering all of addressable 4GiB of memory                      *
-//  *  priv mode    rwx access                                                          *
-//  *  Unpriv mode  no access                                                           *
-//  *  ___________________________________________________________________________      *
-//  * |  ********************                       region #0                     |     *
-//  * |  * 256 KiB          *                       priv mode- r/w access         |     *
-//  * |  * Flash Memory     *                       unpriv mode - r/w access      |     *
-//  * |  * region #1                                                              |     *
-//  * |  * priv mode- rwx   *                                                     |     *
-//  * |  *unpriv mode - rwx *                                                     |     *
-//  * |  ********************       _____________________________                 |     *
-//  * |                             |  31 KiB SRAM (total 32KiB) |                |     *
-//  * |                             |  divided into 32 subregions|                |     *
-//  * |                             |         region #2-5        |                |     *
-//  * |                             |  priv mode- rw access      |                |     *
-//  * |                             |  unpriv mode - no access   |                |     *
-//  * |                             |                            |                |     *
-//  * |                             |____________________________|                |     *
-//  * |                             |      remaining 1 KiB SRAM  |                |     *
-//  * |                             |      priv mode- rw access, |                |     *
-//  * |                             |      unpriv mode rw access |                |     *
-//  * |                             ------------------------------                |     *
-//  * |                                                                           |     *
-//  * |                                     2GiB                                  |     *
-//  * |                                     Peripherals/Bitband                   |     *
-//  * |                                                                           |     *
-//  * |                                                                           |     *
-//  * |                                                                           |     *
-//  * |___________________________________________________________________________|     *
+//  *  region       covers                          priv mode       unpriv mode         *
+//  *  default      all 4GiB (PRIVDEFENA)           rwx access      no access           *
+//  *  #0, #2       window cache slots              rw access       rw or r, per window *
+//  *  #1           256KiB flash                    rwx access      rwx access          *
+//  *  #3-#6        heap 0x2000.2000-0x2000.5FFF    rw access       rw in the enabled   *
+//  *               32 subregions of 512B                           subregions          *
+//  *  #7           heap 0x2000.6000-0x2000.7FFF    rw access       rw in the enabled   *
+//  *               8 subregions of 1KiB                            subregions          *
+//  *                                                                                   *
+//  *  The kernel's 8KiB of SRAM and the peripherals are not mapped for unprivileged    *
+//  *  code, a task reaches them only through the windows it declares. A disabled       *
+//  *  heap subregion falls through to the window slots, then to the default map.       *
 //  *                                                                                   *
 //  *************************************************************************************
 
@@ -78,22 +61,29 @@
 #include "uart0.h"
 #include "tm4c123gh6pm.h"
 
-/*
-* Function: setBackgroundRule() 
-* sets a background rule for all 4GiB of addressable memory
-* RW access (no X access) for both privileged and unprivileged mode for RAM, bitband and peripherals 
-*/
-void setBackgroundRule()
-{   
-    // region #0 for the background region
-    NVIC_MPU_NUMBER_R  = 0x0;        // select region 0
-    NVIC_MPU_BASE_R    = 0x00000000; // addr=0x0000.0000 for complete 4GiB of memory, valid=0, region already set
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
 
-    // S=0, C=1, B=0, size=31(11111 for 4GiB), XN=1(instruction fetch disabled), TEX=000, AP=11 for RW in both modes
-    NVIC_MPU_ATTR_R   = ~NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN | 
-                        ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_4GiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
-    NVIC_MPU_ATTR_R   |= NVIC_MPU_ATTR_ENABLE;        // MPU  region enable
-}
+// base and size of the heap regions 3-7 as setupSramAccess() programs them
+static const uint32_t sramRegionBase[SRAM_REGIONS] =
+{
+    0x20002000, 0x20003000, 0x20004000, 0x20005000, 0x20006000
+};
+static const uint32_t sramRegionSize[SRAM_REGIONS] =
+{
+    NVIC_MPU_ATTR_SIZE_4KiB, NVIC_MPU_ATTR_SIZE_4KiB, NVIC_MPU_ATTR_SIZE_4KiB,
+    NVIC_MPU_ATTR_SIZE_4KiB, NVIC_MPU_ATTR_SIZE_8KiB
+};
+
+static uint64_t loadedSrd = 0;                  // access mask the SRAM regions hold now
+
+// window cache, the first MPU_PINNED_SLOTS slots hold the running task's hottest windows
+static const uint8_t cacheRegion[MPU_CACHE_SLOTS] = {2, 0};
+static uint32_t cacheBase[MPU_CACHE_SLOTS];     // window loaded in each slot, cacheAttr 0 when empty
+static uint32_t cacheAttr[MPU_CACHE_SLOTS];
+static uint8_t cacheVictim = MPU_PINNED_SLOTS;  // unpinned slot the next fault replaces
+MPU_CACHE_STATS mpuCacheStats;
 
 /*
 * Function: allowFlashAccess() 
@@ -107,141 +97,390 @@ void allowFlashAccess(void)
     NVIC_MPU_BASE_R    = 0x00000000; //addr=0x00000000 for base address of flash bits, 256KiB, valid = 0, region already set in the NUMBER register
     
     // S=0, C=1, B=0, size=17(10001) for 256KB, XN=0(instruction fetch enabled), TEX=000
-    NVIC_MPU_ATTR_R    = ~NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | ~NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_256KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_CACHEABLE | (NVIC_MPU_ATTR_SIZE_256KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
     NVIC_MPU_ATTR_R   |= NVIC_MPU_ATTR_ENABLE;        //MPU  region enable
 }
 
-/*
-* Function: allowPeripheralAccess()
-* 
-*/
-void allowPeripheralAccess(void)
-{
-    /*  Implementation Not required since background rule covers it 
-     *  with RW access in both privileged and unprivileged mode
-    */
-}
-
-
 /*
 * Function: setupSramAccess()
-* Creates 6 MPU regions to cover 32KiB of SRAM with 8 sub-regions each
-* Sub-regions created as 8K, 4K, 4K, 4K, 4K, 8K in order from the start of SRAM region
+* Creates 5 MPU regions to cover the 24KiB heap with 8 sub-regions each
+* Regions created as 4K, 4K, 4K, 4K, 8K in order from the start of the heap
 */
 void setupSramAccess(void)
 {
     /*
-    * we divide the 32KiB SRAM into 6 different regions in the MPU
-    * the first and last of those regions in the MPU will protect 8KiB of SRAM each
-    * the other 4 regions will protect 4KiB of SRAM each
-    * the 8KiB within the regions are further divided into 8 subregions of 1KiB each 
+    * the heap, the upper 24KiB of the SRAM, is covered by 5 regions in the MPU
+    * regions 3-6 protect 4KiB of SRAM each, divided into 8 subregions of 512B
+    * region 7 protects the last 8KiB, divided into 8 subregions of 1KiB
+    * the regions give RW access in both modes but start with every subregion disabled;
+    * the running task's access mask enables its own (applySramAccessMask())
+    * the kernel's 8KiB below the heap is left to the privileged default map
     */
 
     /*****************************************************/
-    // first region of SRAM - MPU region 2 (8KiB)
-    // 0x2000.0000-0x2000.1FFF
-    /*****************************************************/
-    NVIC_MPU_NUMBER_R  = 0x2;       //select region 2
-    NVIC_MPU_BASE_R    = 0x20000000;//addr=0x20000000,  valid=0, region already set in NUMBER register
-    
-    // for internal SRAM S=1, C=1, B=0, size=12(1100) for 8KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_8KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
-    // MPU region 2 enabled
-    NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
-
-    /*****************************************************/
-    // second region of SRAM - MPU region 3 (4KiB)
+    // first region of the heap - MPU region 3 (4KiB)
     // 0x2000.2000-0x2000.2FFF
     /*****************************************************/
     NVIC_MPU_NUMBER_R  = 0x3;       //select region 3
     NVIC_MPU_BASE_R    = 0x20002000;//addr=0x20002000,  valid=0, region already set in NUMBER register
     
     // for internal SRAM S=1, C=1, B=0, size=11(1011) for 4KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                         (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW | NVIC_MPU_ATTR_SRD_M;
     // MPU region 3 enabled
     NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
 
     /*****************************************************/
-    // third region of SRAM - MPU region 4 (4KiB)
+    // second region of the heap - MPU region 4 (4KiB)
     // 0x2000.3000-0x2000.3FFF
     /*****************************************************/
     NVIC_MPU_NUMBER_R  = 0x4;       //select region 4
     NVIC_MPU_BASE_R    = 0x20003000;//addr=0x20004000,  valid=0, region already set in NUMBER register
     
     // for internal SRAM S=1, C=1, B=0, size=11(1011) for 4KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                         (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW | NVIC_MPU_ATTR_SRD_M;
     // MPU region 4 enabled
     NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
 
     /*****************************************************/
-    // fourth region of SRAM - MPU region 5 (4KiB)
+    // third region of the heap - MPU region 5 (4KiB)
     // 0x2000.4000-0x2000.4FFF
     /*****************************************************/
     NVIC_MPU_NUMBER_R  = 0x5;       //select region 5
     NVIC_MPU_BASE_R    = 0x20004000;//addr=0x20004000,  valid=0, region already set in NUMBER register
     
     // for internal SRAM S=1, C=1, B=0, size=11(1011) for 4KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                         (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW | NVIC_MPU_ATTR_SRD_M;
     // MPU region 5 enabled
     NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
 
     /*****************************************************/
-    // fifth region of SRAM - MPU region 6 (4KiB)
+    // fourth region of the heap - MPU region 6 (4KiB)
     // 0x2000.5000-0x2000.5FFF
     /*****************************************************/
     NVIC_MPU_NUMBER_R  = 0x6;       //select region 6
     NVIC_MPU_BASE_R    = 0x20005000;//addr=0x20005000,  valid=0, region already set in NUMBER register
     
     // for internal SRAM S=1, C=1, B=0, size=11(1011) for 4KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                         (NVIC_MPU_ATTR_SIZE_4KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW | NVIC_MPU_ATTR_SRD_M;
     // MPU region 6 enabled
     NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
 
     /*****************************************************/
-    // sixth region of SRAM - MPU region 7 (8KiB)
+    // fifth region of the heap - MPU region 7 (8KiB)
     // 0x2000.6000-0x2000.7FFF
     /*****************************************************/
     NVIC_MPU_NUMBER_R  = 0x7;       //select region 7
     NVIC_MPU_BASE_R    = 0x20006000;//addr=0x20006000,  valid=0, region already set in NUMBER register
     
     // for internal SRAM S=1, C=1, B=0, size=12(1100) for 8KiB, XN=1(instruction fetch disabled), TEX=000
-    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | ~NVIC_MPU_ATTR_BUFFRABLE | NVIC_MPU_ATTR_XN |
-                         ~NVIC_MPU_ATTR_TEX_M | (NVIC_MPU_ATTR_SIZE_8KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW; 
+    NVIC_MPU_ATTR_R    = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                         (NVIC_MPU_ATTR_SIZE_8KiB << 1) | NVIC_MPU_ATTR_AP_RW_RW | NVIC_MPU_ATTR_SRD_M;
     // MPU region 7 enabled
     NVIC_MPU_ATTR_R    |= NVIC_MPU_ATTR_ENABLE;
 
+    loadedSrd = createNoSramAcccessMask();
 }
 
+/*
+* Function: sramSubregion()
+* bit of the SRAM access mask covering the address: 8 bits of 1KiB for the kernel's SRAM from bit 0
+* (no region enforces them), then 8 bits each for regions 3-7, 512B in regions 3-6 and 1KiB in region 7
+*/
+static uint8_t sramSubregion(uint32_t address)
+{
+    uint32_t offset = address - SRAM_BASE;
+
+    if (offset < 0x2000)
+        return offset >> 10;
+    if (offset < 0x6000)
+        return 8 + ((offset - 0x2000) >> 9);
+    return 40 + ((offset - 0x6000) >> 10);
+}
+
+/*
+* Function: createNoSramAcccessMask()
+* SRAM access mask with no subregion accessible to unprivileged code
+*/
 uint64_t createNoSramAcccessMask(void)
 {
-    return 1;
+    return 0;
 }
 
+/*
+* Function: applySramAccessMask()
+* loads the SRAM access mask into the subregion disable bits of regions 3-7
+* a set mask bit enables the subregion, clear ones fall through and fault for unprivileged code
+* byte 0 of the mask, the kernel's SRAM, has no region: windows are the way into it
+*/
 void applySramAccessMask(uint64_t srdBitMask)      // called only in privilege mode
 {
+    uint8_t region;
+
+    loadedSrd = srdBitMask;
+    for (region = SRAM_FIRST_REGION; region < SRAM_FIRST_REGION + SRAM_REGIONS; region++)
+    {
+        srdBitMask >>= 8;
+        NVIC_MPU_NUMBER_R = region;
+        NVIC_MPU_ATTR_R = (NVIC_MPU_ATTR_R & ~NVIC_MPU_ATTR_SRD_M) | ((~(uint32_t) srdBitMask & 0xFF) << 8);
+    }
+}
+
+/*
+* Function: buildSramRegionTable()
+* precomputes the RBAR/RASR words of regions 3-7 for an SRAM access mask
+*/
+void buildSramRegionTable(SRAM_REGION_TABLE *table, uint64_t srdBitMask)
+{
+    uint8_t region;
+
+    table->srd = srdBitMask;
+    for (region = 0; region < SRAM_REGIONS; region++)
+    {
+        srdBitMask >>= 8;
+        table->regions[2 * region] = sramRegionBase[region] | NVIC_MPU_BASE_VALID | (SRAM_FIRST_REGION + region);
+        table->regions[2 * region + 1] = NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE | NVIC_MPU_ATTR_XN |
+                                         (sramRegionSize[region] << 1) | NVIC_MPU_ATTR_AP_RW_RW |
+                                         ((~(uint32_t) srdBitMask & 0xFF) << 8) | NVIC_MPU_ATTR_ENABLE;
+    }
+}
+
+/*
+* Function: applySramRegionTable()
+* loads an SRAM access mask through its precomputed table, rebuilding the table if the mask changed
+* only the regions whose SRD byte differs from the loaded mask are written, in one burst
+*/
+void applySramRegionTable(SRAM_REGION_TABLE *table, uint64_t srdBitMask)      // called only in privilege mode
+{
+    uint32_t burst[2 * SRAM_REGIONS];
+    uint64_t changed;
+    uint8_t region, count = 0;
+
+    if (table->srd != srdBitMask || table->regions[1] == 0)
+        buildSramRegionTable(table, srdBitMask);
+
+    changed = (srdBitMask ^ loadedSrd) >> 8;
+    for (region = 0; changed; region++, changed >>= 8)
+    {
+        if (changed & 0xFF)
+        {
+            burst[2 * count] = table->regions[2 * region];
+            burst[2 * count + 1] = table->regions[2 * region + 1];
+            count++;
+        }
+    }
 
+    if (count == SRAM_REGIONS)
+        loadMpuRegions(table->regions, count);
+    else if (count)
+        loadMpuRegions(burst, count);
+    loadedSrd = srdBitMask;
 }
 
+/*
+* Function: addSramAccessWindow()
+* grants access to every subregion touched by [baseAdd, baseAdd + size_in_bytes)
+* a window that is not subregion aligned also opens the neighbouring bytes that share its subregions
+*/
 void addSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes)
 {
+    uint32_t address = (uint32_t) baseAdd;
+    uint8_t first, last;
+
+    if (size_in_bytes == 0 || address < SRAM_BASE || address + size_in_bytes > SRAM_BASE + SRAM_SIZE)
+        return;
 
+    first = sramSubregion(address);
+    last = sramSubregion(address + size_in_bytes - 1);
+    *srdBitMask |= ((2ULL << last) - 1) & ~((1ULL << first) - 1);
+}
+
+/*
+* Function: removeSramAccessWindow()
+* revokes access to every subregion touched by [baseAdd, baseAdd + size_in_bytes)
+*/
+void removeSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes)
+{
+    uint32_t address = (uint32_t) baseAdd;
+    uint8_t first, last;
+
+    if (size_in_bytes == 0 || address < SRAM_BASE || address + size_in_bytes > SRAM_BASE + SRAM_SIZE)
+        return;
+
+    first = sramSubregion(address);
+    last = sramSubregion(address + size_in_bytes - 1);
+    *srdBitMask &= ~(((2ULL << last) - 1) & ~((1ULL << first) - 1));
+}
+
+/*
+* Function: loadCacheSlot()
+* puts a window in a cache slot, or empties the slot for window 0
+*/
+static void loadCacheSlot(uint8_t slot, const MPU_WINDOW *window)
+{
+    cacheBase[slot] = window ? window->base : 0;
+    cacheAttr[slot] = window ? window->attr : 0;
+    NVIC_MPU_BASE_R = cacheBase[slot] | NVIC_MPU_BASE_VALID | cacheRegion[slot];
+    NVIC_MPU_ATTR_R = cacheAttr[slot];
+}
+
+/*
+* Function: cacheSlotOf()
+* slot holding a window, MPU_CACHE_SLOTS if it is not loaded
+*/
+static uint8_t cacheSlotOf(const MPU_WINDOW *window)
+{
+    uint8_t slot;
+
+    for (slot = 0; slot < MPU_CACHE_SLOTS; slot++)
+        if (cacheAttr[slot] == window->attr && cacheBase[slot] == window->base)
+            break;
+    return slot;
+}
+
+/*
+* Function: clearMpuWindowCache()
+* empties the window cache slots, regions 0 and 2
+*/
+void clearMpuWindowCache(void)
+{
+    uint8_t slot;
+
+    for (slot = 0; slot < MPU_CACHE_SLOTS; slot++)
+        loadCacheSlot(slot, 0);
+    cacheVictim = MPU_PINNED_SLOTS;
+}
+
+/*
+* Function: addMpuWindow()
+* declares a window of size bytes (a power of two from 32) at base, which must be aligned to size
+* unprivileged code gets RW access through it, or read only access if writable is false
+*/
+bool addMpuWindow(MPU_WINDOW_LIST *list, uint32_t base, uint32_t size, bool writable)
+{
+    MPU_WINDOW *window = &list->window[list->count];
+    uint8_t bits;
+
+    if (list->count == MAX_TASK_WINDOWS || size < 32 || (size & (size - 1)) || (base & (size - 1)))
+        return false;
+
+    for (bits = 5; (1UL << bits) < size; bits++);
+    window->base = base;
+    window->attr = NVIC_MPU_ATTR_XN | ((uint32_t) (bits - 1) << 1) | NVIC_MPU_ATTR_ENABLE |
+                   (writable ? NVIC_MPU_ATTR_AP_RW_RW : NVIC_MPU_ATTR_AP_RW_RO) |
+                   (base >= MPU_PERIPHERAL_BASE ? NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_BUFFRABLE
+                                                : NVIC_MPU_ATTR_SHAREABLE | NVIC_MPU_ATTR_CACHEABLE);
+    window->faults = 0;
+    list->count++;
+    return true;
+}
+
+/*
+* Function: removeMpuWindow()
+* drops the window declared at base; the cache lets go of it on the next loadMpuWindows()
+*/
+bool removeMpuWindow(MPU_WINDOW_LIST *list, uint32_t base)
+{
+    uint8_t i;
+
+    for (i = 0; i < list->count && list->window[i].base != base; i++);
+    if (i == list->count)
+        return false;
+
+    list->count--;
+    for (; i < list->count; i++)
+        list->window[i] = list->window[i + 1];
+    return true;
+}
+
+/*
+* Function: loadMpuWindows()
+* switches the window cache to a task: its hottest windows go in the pinned slots, and the
+* unpinned slots keep only windows of the same task, the rest are faulted in on demand
+*/
+void loadMpuWindows(MPU_WINDOW_LIST *list)      // called only in privilege mode
+{
+    const MPU_WINDOW *pinned;
+    uint32_t taken = 0;                         // windows already given a pinned slot
+    uint8_t slot, i, hottest;
+
+    for (slot = 0; slot < MPU_PINNED_SLOTS; slot++)
+    {
+        hottest = MAX_TASK_WINDOWS;
+        for (i = 0; i < list->count; i++)
+            if (!(taken & (1 << i)) && (hottest == MAX_TASK_WINDOWS || list->window[i].faults > list->window[hottest].faults))
+                hottest = i;
+
+        pinned = hottest < MAX_TASK_WINDOWS ? &list->window[hottest] : 0;
+        if (pinned)
+            taken |= 1 << hottest;
+        if (pinned && cacheAttr[slot] == pinned->attr && cacheBase[slot] == pinned->base)
+            mpuCacheStats.hits++;
+        else if (pinned || cacheAttr[slot])
+        {
+            loadCacheSlot(slot, pinned);
+            if (pinned)
+                mpuCacheStats.loads++;
+        }
+    }
+
+    for (; slot < MPU_CACHE_SLOTS; slot++)
+    {
+        if (cacheAttr[slot] == 0)
+            continue;
+        for (i = 0; i < list->count && !(cacheAttr[slot] == list->window[i].attr && cacheBase[slot] == list->window[i].base); i++);
+        if (i < list->count)
+            mpuCacheStats.hits++;
+        else
+            loadCacheSlot(slot, 0);
+    }
+}
+
+/*
+* Function: faultInMpuWindow()
+* serves a memory management fault at address from the task's windows: the window covering it is
+* loaded into the next unpinned slot and the access can be retried; returns false for a real violation
+*/
+bool faultInMpuWindow(MPU_WINDOW_LIST *list, uint32_t address)     // called from mpuFaultISR()
+{
+    MPU_WINDOW *window;
+    uint8_t i;
+
+    for (i = 0; i < list->count; i++)
+    {
+        window = &list->window[i];
+        if (address - window->base < (2UL << ((window->attr >> 1) & 0x1F)))
+            break;
+    }
+
+    // no window covers the address, or it is loaded and the access itself is not allowed
+    if (i == list->count || cacheSlotOf(window) < MPU_CACHE_SLOTS)
+    {
+        mpuCacheStats.violations++;
+        return false;
+    }
+
+    if (cacheAttr[cacheVictim])
+        mpuCacheStats.evictions++;
+    loadCacheSlot(cacheVictim, window);
+    cacheVictim = cacheVictim + 1 < MPU_CACHE_SLOTS ? cacheVictim + 1 : MPU_PINNED_SLOTS;
+    window->faults++;
+    mpuCacheStats.misses++;
+    return true;
 }
 
 /*
 * Function: initMPU()
-* Wrapper for three function calls to enable MPU regions 0-7, and enable the MPU
+* Wrapper for three function calls to program MPU regions 0-7, and enable the MPU
 */
 void initMPU()
 {
-    setBackgroundRule();        // enable MPU region #0 - background rule for all 4GiB of memory, RW access for both privileged and unprivileged mode
+    clearMpuWindowCache();      // MPU regions #0 and #2 - window cache slots, empty until a task is switched in
     allowFlashAccess();         // enable MPU region #1 - flash memory region of 256KiB starting at 0x0000.0000
-    setupSramAccess();          // enable MPU regions #2-#7 - 32KiB internal SRAM divided into 6 subregions of 2 8KiB and 4 4KiB regions, all subregions disabled for now
+    setupSramAccess();          // enable MPU regions #3-#7 - 24KiB heap divided into 4 4KiB regions and 1 8KiB region, all subregions disabled for now
 
-    NVIC_MPU_CTRL_R |= NVIC_MPU_CTRL_ENABLE | NVIC_MPU_CTRL_PRIVDEFEN | NVIC_MPU_CTRL_HFNMIENA;       // MPU enable, default region enable, MPU enabled during hard faults
-}
\ No newline at end of file
+    NVIC_MPU_CTRL_R |= NVIC_MPU_CTRL_ENABLE | NVIC_MPU_CTRL_PRIVDEFEN | NVIC_MPU_CTRL_HFNMIENA;       // MPU enable, default region for privileged code only, MPU enabled during hard faults
+}
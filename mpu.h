@@ -2,6 +2,7 @@
 #define MPU_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /* MPU Register bitfield definitions */
 #define NVIC_MPU_ATTR_SIZE_4GiB                 ((0x1F) >> 1)       // SIZE field = 0b11111 for all 4GiB memory
@@ -12,16 +13,74 @@
                                                                     // execute(X) access determined by XN (bit 28) in the ATTR register
 #define NVIC_MPU_ATTR_AP_RW_NONE                0x01000000          // AP = 001 for RW access in only privileged mode
                                                                     // execute(X) access determined by XN (bit 28) in the ATTR register
+#define NVIC_MPU_ATTR_AP_RW_RO                  0x02000000          // AP = 010 for RW access in privileged and read only access in unprivileged mode
+
+#define SRAM_BASE                               0x20000000
+#define SRAM_SIZE                               0x8000              // 32KiB, covered by regions 2-7
+#define SRAM_FIRST_REGION                       3                   // regions 3-7 cover the heap, the upper 24KiB
+#define SRAM_REGIONS                            5
+
+// RBAR/RASR words of the heap regions for one access mask, ready for loadMpuRegions()
+typedef struct _SRAM_REGION_TABLE
+{
+    uint64_t srd;                                                   // access mask the table was built from
+    uint32_t regions[2 * SRAM_REGIONS];                             // RBAR (base, VALID, region) and RASR of regions 3-7
+} SRAM_REGION_TABLE;
+
+#define MPU_PERIPHERAL_BASE                     0x40000000          // windows from here up are device memory
+#define MPU_CACHE_SLOTS                         2                   // MPU regions 2 and 0 hold task windows
+#define MPU_PINNED_SLOTS                        1                   // slots loaded with the hottest windows on a switch
+#define MAX_TASK_WINDOWS                        4
+
+// memory window a task declares, loaded into a cache slot on a switch or when it faults
+typedef struct _MPU_WINDOW
+{
+    uint32_t base;
+    uint32_t attr;                                                  // RASR: size, access and memory type
+    uint32_t faults;                                                // times faulted in, ranks it for pinning
+} MPU_WINDOW;
+
+typedef struct _MPU_WINDOW_LIST
+{
+    MPU_WINDOW window[MAX_TASK_WINDOWS];
+    uint8_t count;
+} MPU_WINDOW_LIST;
+
+typedef struct _MPU_CACHE_STATS
+{
+    uint32_t hits;                                                  // windows found loaded when a task switched in
+    uint32_t loads;                                                 // windows pinned when a task switched in
+    uint32_t misses;                                                // windows faulted in
+    uint32_t evictions;                                             // faults that replaced a loaded window
+    uint32_t violations;                                            // faults no window could serve
+} MPU_CACHE_STATS;
+
+extern MPU_CACHE_STATS mpuCacheStats;
 
 
 void initMPU();
-void setBackgroundRule(void);
 void allowFlashAccess(void);
-void allowPeripheralAccess(void);
 void setupSramAccess(void);
 uint64_t createNoSramAcccessMask(void);
 void applySramAccessMask(uint64_t);
+void buildSramRegionTable(SRAM_REGION_TABLE*, uint64_t);
+void applySramRegionTable(SRAM_REGION_TABLE*, uint64_t);
 void addSramAccessWindow(uint64_t*, uint32_t*, uint32_t);
+void removeSramAccessWindow(uint64_t*, uint32_t*, uint32_t);
+void clearMpuWindowCache(void);
+bool addMpuWindow(MPU_WINDOW_LIST*, uint32_t, uint32_t, bool);
+bool removeMpuWindow(MPU_WINDOW_LIST*, uint32_t);
+void loadMpuWindows(MPU_WINDOW_LIST*);
+bool faultInMpuWindow(MPU_WINDOW_LIST*, uint32_t);
+
+/* MPU assembly functions (mpu_s.s) */
+void unprivilegedMode(void);
+void setThreadPrivilege(bool);
+void setPSPaddress(uint32_t);
+uint32_t getPSPaddress(void);
+uint32_t getMSPaddress(void);
+void setASPbit(void);
+void loadMpuRegions(const uint32_t*, uint32_t);
 
 
 #endif /* MPU_H_ */
\ No newline at end of file
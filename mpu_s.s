@@ -1,10 +1,12 @@
 ; MPU assembly functions
 
 	.def unprivilegedMode
+	.def setThreadPrivilege
 	.def setPSPaddress
 	.def getPSPaddress
 	.def getMSPaddress
 	.def setASPbit
+	.def loadMpuRegions
 
 
 .thumb
@@ -25,16 +27,68 @@ getMSPaddress:
 		BX		LR
 
 unprivilegedMode:
-			MRS 	R4, CONTROL
-			ORR 	R4, R4, #0x01				; set the TMPL bit in CONTROL register
-			MSR		CONTROL, R4
+			MRS 	R0, CONTROL
+			ORR 	R0, R0, #0x01				; set the TMPL bit in CONTROL register
+			MSR		CONTROL, R0
+			ISB									; make the new mode effective before the next instruction
 			BX 		LR
 
+; called from taskSwitch() in handler mode: R0 = 0 makes thread mode unprivileged (nPRIV set)
+; from the next exception return on, any other value privileged
+setThreadPrivilege:
+			MRS		R1, CONTROL
+			BIC		R1, R1, #0x01
+			CMP		R0, #0
+			IT		EQ
+			ORREQ	R1, R1, #0x01				; nPRIV for an unprivileged thread
+			MSR		CONTROL, R1
+			ISB
+			BX		LR
+
 setASPbit:
-			MRS 	R4, CONTROL
-			ORR 	R4, R4, #0x2				; set the ASP bit in CONTROL register
-			MSR		CONTROL, R4
+			MRS 	R0, CONTROL
+			ORR 	R0, R0, #0x2				; set the ASP bit in CONTROL register
+			MSR		CONTROL, R0
+			ISB									; thread mode uses the PSP from the next instruction on
 			BX 		LR
 
+; loads R1 RBAR/RASR pairs from R0 into the MPU; each RBAR carries VALID and its region
+; number, so four pairs go out in one STM to RBAR, RASR and the three alias pairs
+loadMpuRegions:
+			PUSH	{R4-R9}
+			LDR		R2, mpuRbarAddr
+mpuBurst4:
+			CMP		R1, #4
+			BLO		mpuBurst3
+			LDM		R0!, {R3-R9, R12}
+			STM		R2, {R3-R9, R12}
+			SUBS	R1, R1, #4
+			B		mpuBurst4
+mpuBurst3:
+			CMP		R1, #3
+			BNE		mpuBurst2
+			LDM		R0, {R3-R8}
+			STM		R2, {R3-R8}
+			B		mpuLoaded
+mpuBurst2:
+			CMP		R1, #2
+			BNE		mpuBurst1
+			LDM		R0, {R3-R6}
+			STM		R2, {R3-R6}
+			B		mpuLoaded
+mpuBurst1:
+			CBZ		R1, mpuLoaded
+			LDM		R0, {R3-R4}
+			STM		R2, {R3-R4}
+mpuLoaded:
+			DSB									; new regions in effect before returning
+			ISB
+			POP		{R4-R9}
+			BX		LR
+
+			.align	4
+mpuRbarAddr:
+			.word	0xE000ED9C					; NVIC_MPU_BASE_R, followed by ATTR and the alias pairs
+
 
 .endm
\ No newline at end of file
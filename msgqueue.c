@@ -0,0 +1,352 @@
+/*
+ *      Filename: msgqueue.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Zero-copy message queues
+//
+// A message is a block of a fixed-size pool, and what travels through a queue
+// is the block number, never the payload. Every block has exactly one owner at
+// a time: the task that allocated or received it, or the queue it sits in.
+// Sending hands the block on, so the sender must not touch it afterwards, and
+// with MPU isolation on that is enforced: the block's SRAM subregions leave
+// the sender's access mask and join the receiver's. The blocks are kernel
+// allocations from the heap, which hands out whole subregions (one of 1KiB or
+// two of 512B each), so a window never opens another block.
+//
+// When a receiver is already waiting, a send skips the queue and gives the
+// block to it directly; likewise a receive that frees a slot moves the message
+// of the first blocked sender in.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tm4c123gh6pm.h"
+#include "kernel.h"
+#include "mpu.h"
+#include "msgqueue.h"
+#include "semaphore.h"
+#include "heap.h"
+#include "terminal.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+MSG_QUEUE queues[MAX_QUEUES];
+SLAB queuePool = SLAB_INIT("queues", queues, MSG_QUEUE, senders);
+
+#define BLOCK_FREE              ((TCB *) 0)
+#define BLOCK_QUEUED            ((TCB *) 1)
+
+static uint8_t *msgPool[MSG_POOL_BLOCKS];       // taken from the heap by the first createQueue() or allocMessage()
+static TCB *blockOwner[MSG_POOL_BLOCKS];        // owning task, BLOCK_FREE or BLOCK_QUEUED
+static uint16_t blockLength[MSG_POOL_BLOCKS];   // bytes used by the message
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: messageBlock()
+* pool block of a message pointer, MSG_POOL_BLOCKS if it is not the start of a block
+*/
+static uint8_t messageBlock(void *message)
+{
+    uint8_t block;
+
+    for (block = 0; block < MSG_POOL_BLOCKS && (msgPool[block] == 0 || msgPool[block] != message); block++);
+    return block;
+}
+
+/*
+* Function: setBlockOwner()
+* moves a block to a new owner, taking its subregions out of the old owner's access mask and
+* adding them to the new one's
+* must be called with interrupts disabled
+*/
+static void setBlockOwner(uint8_t block, TCB *owner)
+{
+    TCB *old = blockOwner[block];
+
+    if (old != BLOCK_FREE && old != BLOCK_QUEUED)
+        removeSramAccessWindow(&old->srd, (uint32_t *) msgPool[block], MSG_BLOCK_SIZE);
+    if (owner != BLOCK_FREE && owner != BLOCK_QUEUED)
+        addSramAccessWindow(&owner->srd, (uint32_t *) msgPool[block], MSG_BLOCK_SIZE);
+    blockOwner[block] = owner;
+
+    if (getMpuIsolation() && (old == taskCurrent || owner == taskCurrent))
+        applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+}
+
+/*
+* Function: initMessagePool()
+* takes the pool blocks that are still missing from the heap, owned by the kernel
+* must be called with interrupts disabled
+*/
+static void initMessagePool(void)
+{
+    uint8_t block;
+
+    for (block = 0; block < MSG_POOL_BLOCKS; block++)
+        if (msgPool[block] == 0)
+            msgPool[block] = heapAllocate(MSG_BLOCK_SIZE, 0, 0);
+}
+
+/*
+* Function: createQueue()
+* returns the handle of a new queue holding up to depth messages, INVALID_QUEUE if none is free
+*/
+uint8_t createQueue(const char name[], uint8_t depth)
+{
+    uint8_t i, j;
+    MSG_QUEUE *object;
+    uint32_t irqState;
+
+    if (depth == 0 || depth > MAX_QUEUE_DEPTH)
+        return INVALID_QUEUE;
+
+    irqState = _disable_interrupts();
+    object = slabAlloc(&queuePool);
+    if (object == 0)
+    {
+        _restore_interrupts(irqState);
+        return INVALID_QUEUE;
+    }
+    i = slabIndex(&queuePool, object);
+
+    initMessagePool();
+
+    queues[i].valid = true;
+    queues[i].depth = depth;
+    queues[i].count = 0;
+    queues[i].first = 0;
+    queues[i].senders = 0;
+    queues[i].receivers = 0;
+    queues[i].sent = 0;
+    for (j = 0; j < MAX_QUEUE_NAME_LENGTH && name[j] != 0; j++)
+        queues[i].name[j] = name[j];
+    queues[i].name[j] = 0;
+
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: findQueue()
+* handle of the queue with the given name, INVALID_QUEUE if there is none
+*/
+uint8_t findQueue(const char name[])
+{
+    uint8_t i;
+
+    for (i = 0; i < MAX_QUEUES; i++)
+        if (queues[i].valid && stringCompare(queues[i].name, name))
+            return i;
+    return INVALID_QUEUE;
+}
+
+/*
+* Function: allocMessage()
+* gives the caller a free message block, 0 if the pool is empty
+*/
+void *allocMessage(void)
+{
+    uint8_t block;
+    uint32_t irqState = _disable_interrupts();
+
+    initMessagePool();
+    for (block = 0; block < MSG_POOL_BLOCKS && (msgPool[block] == 0 || blockOwner[block] != BLOCK_FREE); block++);
+    if (block == MSG_POOL_BLOCKS)
+    {
+        _restore_interrupts(irqState);
+        return 0;
+    }
+    blockLength[block] = 0;
+    setBlockOwner(block, taskCurrent);
+    _restore_interrupts(irqState);
+    return msgPool[block];
+}
+
+/*
+* Function: freeMessage()
+* returns a message block owned by the caller to the pool
+*/
+bool freeMessage(void *message)
+{
+    uint8_t block = messageBlock(message);
+    uint32_t irqState = _disable_interrupts();
+
+    if (block == MSG_POOL_BLOCKS || blockOwner[block] != taskCurrent)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+    setBlockOwner(block, BLOCK_FREE);
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: messageLength()
+* bytes used by a message block the caller owns, 0 for any other block
+*/
+uint16_t messageLength(void *message)
+{
+    uint8_t block = messageBlock(message);
+
+    if (block == MSG_POOL_BLOCKS || blockOwner[block] != taskCurrent)
+        return 0;
+    return blockLength[block];
+}
+
+/*
+* Function: sendMessage()
+* passes a message block owned by the caller to the queue, blocking for up to timeoutMs
+* (NO_WAIT, WAIT_FOREVER) while it is full; the caller keeps the block if this fails
+*/
+bool sendMessage(uint8_t queue, void *message, uint16_t length, uint32_t timeoutMs)
+{
+    MSG_QUEUE *q = &queues[queue];
+    uint8_t block = messageBlock(message);
+    TCB *receiver;
+    uint32_t irqState;
+
+    if (queue >= MAX_QUEUES || !q->valid || block == MSG_POOL_BLOCKS || length > MSG_BLOCK_SIZE)
+        return false;
+
+    irqState = _disable_interrupts();
+    if (blockOwner[block] != taskCurrent)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+    blockLength[block] = length;
+
+    receiver = q->receivers;
+    if (receiver)
+    {
+        // somebody is waiting, skip the queue
+        waitQueueRemove(&q->receivers, receiver);
+        setBlockOwner(block, receiver);
+        receiver->waitData = message;
+        readyTask(receiver);
+        q->sent++;
+    }
+    else if (q->count < q->depth)
+    {
+        q->slot[(q->first + q->count) % q->depth] = block;
+        q->count++;
+        setBlockOwner(block, BLOCK_QUEUED);
+        q->sent++;
+    }
+    else if (timeoutMs == NO_WAIT)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+    else
+    {
+        // receiveMessage() moves the block into the queue when it frees a slot
+        taskCurrent->waitData = message;
+        if (timeoutMs == WAIT_FOREVER)
+            blockCurrentTask(&q->senders, q);
+        else
+            blockCurrentTaskTimeout(&q->senders, q, msToTicks(timeoutMs));
+        _restore_interrupts(irqState);
+        return !taskCurrent->timedOut;
+    }
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: receiveMessage()
+* takes the oldest message from the queue, blocking for up to timeoutMs (NO_WAIT, WAIT_FOREVER)
+* while it is empty; the caller owns the block until it sends or frees it
+* returns 0 on timeout
+*/
+void *receiveMessage(uint8_t queue, uint16_t *length, uint32_t timeoutMs)
+{
+    MSG_QUEUE *q = &queues[queue];
+    TCB *sender;
+    uint8_t block;
+    void *message;
+    uint32_t irqState;
+
+    if (queue >= MAX_QUEUES || !q->valid)
+        return 0;
+
+    irqState = _disable_interrupts();
+    if (q->count > 0)
+    {
+        block = q->slot[q->first];
+        q->first = (q->first + 1) % q->depth;
+        q->count--;
+        setBlockOwner(block, taskCurrent);
+
+        // the freed slot goes to the first blocked sender
+        sender = q->senders;
+        if (sender)
+        {
+            waitQueueRemove(&q->senders, sender);
+            q->slot[(q->first + q->count) % q->depth] = messageBlock(sender->waitData);
+            q->count++;
+            setBlockOwner(messageBlock(sender->waitData), BLOCK_QUEUED);
+            q->sent++;
+            readyTask(sender);
+        }
+        message = msgPool[block];
+    }
+    else if (timeoutMs == NO_WAIT)
+        message = 0;
+    else
+    {
+        // sendMessage() hands the block over through waitData
+        taskCurrent->waitData = 0;
+        if (timeoutMs == WAIT_FOREVER)
+            blockCurrentTask(&q->receivers, q);
+        else
+            blockCurrentTaskTimeout(&q->receivers, q, msToTicks(timeoutMs));
+        _restore_interrupts(irqState);
+
+        irqState = _disable_interrupts();
+        message = taskCurrent->timedOut ? 0 : taskCurrent->waitData;
+    }
+
+    if (message && length)
+        *length = blockLength[messageBlock(message)];
+    _restore_interrupts(irqState);
+    return message;
+}
+
+/*
+* Function: releaseTaskMessages()
+* returns the message blocks held by a task that is being killed to the pool, including
+* one it was blocked sending
+* must be called with interrupts disabled
+*/
+void releaseTaskMessages(TCB *task)
+{
+    uint8_t block;
+
+    for (block = 0; block < MSG_POOL_BLOCKS; block++)
+        if (msgPool[block] && blockOwner[block] == task)
+            setBlockOwner(block, BLOCK_FREE);
+}
+
+/*
+* Function: freeMessageBlocks()
+* number of message blocks left in the pool
+*/
+uint8_t freeMessageBlocks(void)
+{
+    uint8_t block, count = 0;
+
+    for (block = 0; block < MSG_POOL_BLOCKS; block++)
+        if (msgPool[block] && blockOwner[block] == BLOCK_FREE)
+            count++;
+    return count;
+}
@@ -0,0 +1,52 @@
+/*
+ *      Filename: msgqueue.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef MSGQUEUE_H_
+#define MSGQUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Message Queue Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_QUEUE_NAME_LENGTH   15
+#define MAX_QUEUE_DEPTH         8
+#define INVALID_QUEUE           0xFF
+
+#define MSG_BLOCK_SIZE          1024        // one 1KiB or two 512B heap subregions
+#define MSG_POOL_BLOCKS         4
+
+typedef struct _MSG_QUEUE
+{
+    bool valid;
+    uint8_t depth;                          // capacity in messages
+    uint8_t count;                          // messages queued
+    uint8_t first;                          // slot of the oldest message
+    uint8_t slot[MAX_QUEUE_DEPTH];          // pool block of each queued message
+    TCB *senders;                           // tasks blocked on a full queue, highest priority first
+    TCB *receivers;                         // tasks blocked on an empty queue, highest priority first
+    char name[MAX_QUEUE_NAME_LENGTH + 1];
+    uint32_t sent;                          // messages delivered through the queue
+} MSG_QUEUE;
+
+extern MSG_QUEUE queues[MAX_QUEUES];
+extern SLAB queuePool;
+
+uint8_t createQueue(const char name[], uint8_t depth);
+uint8_t findQueue(const char name[]);
+void *allocMessage(void);
+bool freeMessage(void *message);
+uint16_t messageLength(void *message);
+bool sendMessage(uint8_t queue, void *message, uint16_t length, uint32_t timeoutMs);
+void *receiveMessage(uint8_t queue, uint16_t *length, uint32_t timeoutMs);
+void releaseTaskMessages(TCB *task);
+uint8_t freeMessageBlocks(void);
+
+#endif
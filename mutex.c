@@ -0,0 +1,435 @@
+/*
+ *      Filename: mutex.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Kernel mutexes with transitive priority inheritance
+//
+// A task that blocks on a mutex lends its priority to the owner, and to the owner
+// of any mutex that owner is blocked on, and so on down the chain, so a low
+// priority holder cannot be starved by medium priority tasks while a high
+// priority task waits. On unlock the owner drops back to the highest priority
+// still owed to it by the mutexes it keeps holding, or to its base priority.
+// Inheritance can be switched off at runtime ("pi off") for comparison.
+//
+// Ceiling mutexes use the immediate priority ceiling protocol instead: the
+// locking task is raised to the ceiling of the mutex at once, so no other user
+// can run (let alone block on it) until it is released. That rules out chained
+// blocking and deadlock between ceiling mutexes and leaves the lock and unlock
+// paths without any wait queue work. A ceiling mutex shared with interrupt
+// handlers can also raise BASEPRI, which masks those handlers and task switches
+// (PendSV) while it is held. The BASEPRI owed is kept in the owner's TCB and
+// loaded by taskSwitch(), and because PendSV is masked the owner cannot give up
+// the processor: sleep and blocking calls fail while it holds such a mutex. The
+// wait queue is only used if the owner of a ceiling mutex without BASEPRI gives
+// up the processor while holding it (sleep, yield or a time slice).
+//
+// Every held mutex, of either protocol, is on a doubly linked list in its owner's
+// TCB, so unlocking unlinks it in O(1) and a killed task can give back everything
+// it holds (releaseTaskMutexes) without scanning the mutex table.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tm4c123gh6pm.h"
+#include "kernel.h"
+#include "mutex.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+MUTEX mutexes[MAX_MUTEXES];
+SLAB mutexPool = SLAB_INIT("mutexes", mutexes, MUTEX, waiters);
+
+static bool priorityInheritance = true;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: inheritedPriority()
+* highest priority a task is owed: its base priority, the ceiling of any ceiling mutex it
+* holds or the top waiter of any inheritance mutex it holds
+* derived from the held mutexes rather than saved at lock time, so ceiling mutexes may be
+* released in any order
+*/
+static uint8_t inheritedPriority(TCB *task)
+{
+    uint8_t priority = task->basePriority;
+    MUTEX *m;
+
+    for (m = task->ownedMutexes; m != 0; m = m->ownedNext)
+    {
+        if (m->protocol == MUTEX_CEILING)
+        {
+            if (m->ceiling < priority)
+                priority = m->ceiling;
+        }
+        else if (priorityInheritance && m->waiters && m->waiters->priority < priority)
+            priority = m->waiters->priority;
+    }
+    return priority;
+}
+
+/*
+* Function: heldBasepri()
+* BASEPRI owed to the ceiling mutexes a task holds: the most restrictive (lowest non-zero)
+* of theirs, 0 if none of them masks interrupts
+*/
+static uint8_t heldBasepri(TCB *task)
+{
+    uint8_t basepri = 0;
+    MUTEX *m;
+
+    for (m = task->ownedMutexes; m != 0; m = m->ownedNext)
+        if (m->basepri && (basepri == 0 || m->basepri < basepri))
+            basepri = m->basepri;
+    return basepri;
+}
+
+/*
+* Function: propagateInheritance()
+* walks the chain of owners starting at mutex m, boosting each one to the priority of the waiter
+*/
+static void propagateInheritance(MUTEX *m, TCB *waiter)
+{
+    TCB *owner;
+
+    while (m && (owner = m->owner) != 0 && owner->priority > waiter->priority)
+    {
+        setTaskPriority(owner, waiter->priority);
+        m->boosts++;
+
+        // transitive step: the owner may itself be waiting on another mutex
+        if (owner->state != STATE_BLOCKED || owner->waitQueue == 0)
+            break;
+        m = owner->blockedOn;
+        if (m < mutexes || m >= mutexes + MAX_MUTEXES)
+            break;                                      // blocked on something other than a mutex
+        waiter = owner;
+    }
+}
+
+/*
+* Function: ownMutex()
+* makes a task the owner of a mutex and puts the mutex on the task's list, O(1)
+*/
+static void ownMutex(MUTEX *m, TCB *task)
+{
+    MUTEX *head = task->ownedMutexes;
+
+    m->owner = task;
+    m->ownedPrev = 0;
+    m->ownedNext = head;
+    if (head)
+        head->ownedPrev = m;
+    task->ownedMutexes = m;
+}
+
+/*
+* Function: disownMutex()
+* takes a mutex off its owner's list and leaves it without an owner, O(1)
+*/
+static void disownMutex(MUTEX *m)
+{
+    if (m->ownedPrev)
+        m->ownedPrev->ownedNext = m->ownedNext;
+    else
+        m->owner->ownedMutexes = m->ownedNext;
+    if (m->ownedNext)
+        m->ownedNext->ownedPrev = m->ownedPrev;
+    m->ownedNext = 0;
+    m->ownedPrev = 0;
+    m->owner = 0;
+}
+
+/*
+* Function: handOver()
+* passes a free mutex to its first waiter, if any, and readies it
+*/
+static void handOver(MUTEX *m)
+{
+    TCB *next = m->waiters;
+    uint32_t blocked;
+
+    if (next == 0)
+        return;
+
+    waitQueueRemove(&m->waiters, next);
+    blocked = DWT_CYCCNT_R - next->blockStart;
+    if (blocked > m->maxBlockCycles)
+        m->maxBlockCycles = blocked;
+
+    // a ceiling mutex raises the new owner to its ceiling here, taskSwitch() loads its BASEPRI once it runs
+    ownMutex(m, next);
+    next->basepri = heldBasepri(next);
+    setTaskPriority(next, inheritedPriority(next));
+    readyTask(next);
+}
+
+/*
+* Function: newMutex()
+* returns the handle of a new, unlocked mutex, or INVALID_MUTEX if none are left
+*/
+static uint8_t newMutex(const char name[], uint8_t protocol, uint8_t ceiling, uint8_t basepri)
+{
+    uint8_t i, j;
+    MUTEX *object;
+    uint32_t irqState = _disable_interrupts();
+
+    object = slabAlloc(&mutexPool);
+    if (object == 0)
+    {
+        _restore_interrupts(irqState);
+        return INVALID_MUTEX;
+    }
+    i = slabIndex(&mutexPool, object);
+
+    mutexes[i].valid = true;
+    mutexes[i].protocol = protocol;
+    mutexes[i].ceiling = ceiling;
+    mutexes[i].basepri = basepri;
+    mutexes[i].owner = 0;
+    mutexes[i].waiters = 0;
+    mutexes[i].ownedNext = 0;
+    mutexes[i].ownedPrev = 0;
+    mutexes[i].boosts = 0;
+    mutexes[i].maxBlockCycles = 0;
+    for (j = 0; j < MAX_MUTEX_NAME_LENGTH && name[j] != 0; j++)
+        mutexes[i].name[j] = name[j];
+    mutexes[i].name[j] = 0;
+
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: createMutex()
+* priority inheritance mutex
+*/
+uint8_t createMutex(const char name[])
+{
+    return newMutex(name, MUTEX_INHERIT, 0, 0);
+}
+
+/*
+* Function: createCeilingMutex()
+* immediate priority ceiling mutex, ceiling must be the priority of its highest priority user
+* isrPriority: NVIC priority (1-7) of the highest priority handler sharing the data, 0 if none
+*/
+uint8_t createCeilingMutex(const char name[], uint8_t ceiling, uint8_t isrPriority)
+{
+    if (ceiling > LOWEST_PRIORITY || isrPriority > 7)
+        return INVALID_MUTEX;
+    return newMutex(name, MUTEX_CEILING, ceiling, isrPriority << 5);
+}
+
+/*
+* Function: lockCeilingMutex()
+* raises the caller to the ceiling and takes the mutex
+*/
+static bool lockCeilingMutex(MUTEX *m)
+{
+    uint32_t irqState;
+
+    // a task above the ceiling would break the protocol
+    if (taskCurrent->basePriority < m->ceiling)
+        return false;
+
+    // raising the running task needs no switch, setTaskPriority() only moves it up a level
+    irqState = _disable_interrupts();
+    if (m->owner == 0)
+    {
+        ownMutex(m, taskCurrent);
+        if (m->ceiling < taskCurrent->priority)
+            setTaskPriority(taskCurrent, m->ceiling);
+    }
+    else if (m->owner != taskCurrent)
+    {
+        // the owner gave up the processor while holding it, handOver() makes this task
+        // the owner before it runs again
+        if (!blockCurrentTask(&m->waiters, m))
+        {
+            _restore_interrupts(irqState);
+            return false;
+        }
+        _restore_interrupts(irqState);
+        irqState = _disable_interrupts();
+    }
+    taskCurrent->basepri = heldBasepri(taskCurrent);
+    _set_interrupt_priority(taskCurrent->basepri);
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: unlockCeilingMutex()
+* drops the caller back to the priority (and BASEPRI) owed to the mutexes it still holds,
+* switching only if that leaves a higher priority task ready
+*/
+static bool unlockCeilingMutex(MUTEX *m)
+{
+    uint32_t irqState = _disable_interrupts();
+
+    if (m->owner != taskCurrent)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+
+    disownMutex(m);
+    taskCurrent->basepri = heldBasepri(taskCurrent);
+    _set_interrupt_priority(taskCurrent->basepri);
+    setTaskPriority(taskCurrent, inheritedPriority(taskCurrent));
+    handOver(m);
+
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: lockMutex()
+* takes the mutex, blocking until the owner releases it
+* returns false for an invalid handle, a ceiling violation or a caller that may not block
+*/
+bool lockMutex(uint8_t mutex)
+{
+    MUTEX *m = &mutexes[mutex];
+    uint32_t irqState;
+
+    if (mutex >= MAX_MUTEXES || !m->valid)
+        return false;
+    if (m->protocol == MUTEX_CEILING)
+        return lockCeilingMutex(m);
+
+    irqState = _disable_interrupts();
+    if (m->owner == 0)
+        ownMutex(m, taskCurrent);
+    else if (m->owner != taskCurrent)
+    {
+        if (!blockCurrentTask(&m->waiters, m))
+        {
+            _restore_interrupts(irqState);
+            return false;
+        }
+        if (priorityInheritance)
+            propagateInheritance(m, taskCurrent);
+        // ownership is handed over by unlockMutex() before this task runs again
+    }
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: unlockMutex()
+* releases the mutex and hands it to the highest priority waiter
+* returns false if the caller does not own the mutex
+*/
+bool unlockMutex(uint8_t mutex)
+{
+    MUTEX *m = &mutexes[mutex];
+    uint32_t irqState;
+
+    if (mutex >= MAX_MUTEXES || !m->valid)
+        return false;
+    if (m->protocol == MUTEX_CEILING)
+        return unlockCeilingMutex(m);
+
+    irqState = _disable_interrupts();
+    if (m->owner != taskCurrent)
+    {
+        _restore_interrupts(irqState);
+        return false;
+    }
+
+    // drop the mutex from the owner's list and give back any priority it was lent for it
+    disownMutex(m);
+    handOver(m);
+    setTaskPriority(taskCurrent, inheritedPriority(taskCurrent));
+
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: setPriorityInheritance()
+* turns priority inheritance on or off, owners that were boosted drop back right away when turned off
+*/
+void setPriorityInheritance(bool on)
+{
+    uint8_t i, priority;
+    bool changed;
+    uint32_t irqState = _disable_interrupts();
+
+    priorityInheritance = on;
+
+    // repeat until stable so boosts also settle along chains of owners
+    do
+    {
+        changed = false;
+        for (i = 0; i < MAX_TASKS; i++)
+        {
+            if (tcb[i].state == STATE_INVALID)
+                continue;
+            priority = inheritedPriority(&tcb[i]);
+            if (priority != tcb[i].priority)
+            {
+                setTaskPriority(&tcb[i], priority);
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    _restore_interrupts(irqState);
+}
+
+bool getPriorityInheritance(void)
+{
+    return priorityInheritance;
+}
+
+/*
+* Function: releaseTaskMutexes()
+* takes a task that is being killed out of the mutex graph: it leaves the wait queue of a
+* mutex it is blocked on, the owners it was boosting down the inheritance chain giving back
+* the priority lent for it, and every mutex it holds passes to the first waiter or becomes free
+* must be called with interrupts disabled
+*/
+void releaseTaskMutexes(TCB *task)
+{
+    MUTEX *m = task->blockedOn;
+    TCB *owner;
+    uint8_t priority;
+
+    if (task->state == STATE_BLOCKED && task->waitQueue && m >= mutexes && m < mutexes + MAX_MUTEXES)
+    {
+        waitQueueRemove(task->waitQueue, task);
+        task->waitQueue = 0;
+        task->blockedOn = 0;
+
+        // the boost it lent may have gone down a chain of owners, each one drops back in turn;
+        // an owner whose priority stays put ends the walk, nothing further down changes either
+        while (m->protocol == MUTEX_INHERIT && (owner = m->owner) != 0)
+        {
+            priority = inheritedPriority(owner);
+            if (priority == owner->priority)
+                break;
+            setTaskPriority(owner, priority);
+            if (owner->state != STATE_BLOCKED || owner->waitQueue == 0)
+                break;
+            m = owner->blockedOn;
+            if (m < mutexes || m >= mutexes + MAX_MUTEXES)
+                break;                                  // blocked on something other than a mutex
+        }
+    }
+
+    while ((m = task->ownedMutexes) != 0)
+    {
+        disownMutex(m);
+        handOver(m);
+    }
+}
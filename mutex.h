@@ -0,0 +1,54 @@
+/*
+ *      Filename: mutex.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef MUTEX_H_
+#define MUTEX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Mutex Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_MUTEX_NAME_LENGTH   15
+#define INVALID_MUTEX           0xFF
+
+typedef enum _mutex_protocol_
+{
+    MUTEX_INHERIT,                          // priority inheritance, owners are boosted by their waiters
+    MUTEX_CEILING                           // immediate priority ceiling, owners run at the ceiling while holding
+} mutexProtocol;
+
+typedef struct _MUTEX
+{
+    bool valid;
+    uint8_t protocol;                       // one of mutexProtocol
+    uint8_t ceiling;                        // MUTEX_CEILING: priority of the highest priority user
+    uint8_t basepri;                        // MUTEX_CEILING: BASEPRI while held (0 = interrupts not masked)
+    TCB *owner;                             // task holding the mutex, 0 if free
+    TCB *waiters;                           // blocked tasks, highest priority first
+    struct _MUTEX *ownedNext;               // mutexes held by the same owner (doubly linked)
+    struct _MUTEX *ownedPrev;
+    char name[MAX_MUTEX_NAME_LENGTH + 1];
+    uint32_t boosts;                        // priority inheritance boosts caused by this mutex
+    uint32_t maxBlockCycles;                // longest time a task waited for this mutex
+} MUTEX;
+
+extern MUTEX mutexes[MAX_MUTEXES];
+extern SLAB mutexPool;
+
+uint8_t createMutex(const char name[]);
+uint8_t createCeilingMutex(const char name[], uint8_t ceiling, uint8_t isrPriority);
+bool lockMutex(uint8_t mutex);
+bool unlockMutex(uint8_t mutex);
+void setPriorityInheritance(bool on);
+bool getPriorityInheritance(void);
+void releaseTaskMutexes(TCB *task);
+
+#endif
@@ -16,6 +16,10 @@
 #define GREEN_LED *((volatile uint32_t*) (0x42000000 + (0x400253FC - 0x40000000) * 32 + 3 * 4))
 #define BLUE_LED *((volatile uint32_t*) (0x42000000 + (0x400253FC - 0x40000000) * 32 + 2 * 4))
 
+// bit-band aliases of the 8 port F data bits, the MPU window an unprivileged task needs for the LEDs
+#define LED_WINDOW_BASE (0x42000000 + (0x400253FC - 0x40000000) * 32)
+#define LED_WINDOW_SIZE 32
+
 typedef enum _led_color_{RED, BLUE, GREEN} ledColor;
 typedef enum _led_state_{ON, OFF} ledState;
 
@@ -0,0 +1,116 @@
+/*
+ *      Filename: registry.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Task name registry
+//
+// Shell commands that take a process name (pidof, pkill) look tasks up here
+// instead of comparing the name of every TCB. Names are keyed by a case
+// insensitive 32-bit FNV-1a hash, computed once when the task is created and
+// kept in its TCB. The table uses open addressing with linear probing and is at
+// most half full, so a lookup is one hash of the name, a short probe and one
+// confirming stringCompare() per match. Tasks may share a name; all of them sit
+// in the same probe run. Removal shifts the rest of the run back instead of
+// leaving tombstones, so the table never degrades as tasks come and go.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "registry.h"
+#include "terminal.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint8_t registrySlot[REGISTRY_SLOTS];        // tcb index + 1 of the task in each slot
+static uint32_t registryHash[REGISTRY_SLOTS];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: nameHash()
+* 32-bit FNV-1a of a name with ASCII letters folded to lower case
+*/
+uint32_t nameHash(const char name[])
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    char c;
+
+    while ((c = *name++) != 0)
+    {
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        hash = (hash ^ (uint8_t) c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/*
+* Function: registerTask()
+* adds a task under the hash of its name, taken into task->nameHash
+* must be called with interrupts disabled
+*/
+void registerTask(TCB *task)
+{
+    uint8_t i;
+
+    task->nameHash = nameHash(task->name);
+    for (i = task->nameHash & (REGISTRY_SLOTS - 1); registrySlot[i] != REGISTRY_EMPTY; i = (i + 1) & (REGISTRY_SLOTS - 1));
+    registrySlot[i] = task - tcb + 1;
+    registryHash[i] = task->nameHash;
+}
+
+/*
+* Function: unregisterTask()
+* removes a task and moves later entries of its probe run back into the hole
+* must be called with interrupts disabled
+*/
+void unregisterTask(TCB *task)
+{
+    uint8_t i, j, home;
+    uint8_t index = task - tcb + 1;
+
+    for (i = task->nameHash & (REGISTRY_SLOTS - 1); registrySlot[i] != index; i = (i + 1) & (REGISTRY_SLOTS - 1))
+        if (registrySlot[i] == REGISTRY_EMPTY)
+            return;
+
+    // an entry may fill the hole unless its home slot lies cyclically in (hole, entry]
+    for (j = (i + 1) & (REGISTRY_SLOTS - 1); registrySlot[j] != REGISTRY_EMPTY; j = (j + 1) & (REGISTRY_SLOTS - 1))
+    {
+        home = registryHash[j] & (REGISTRY_SLOTS - 1);
+        if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+            continue;
+        registrySlot[i] = registrySlot[j];
+        registryHash[i] = registryHash[j];
+        i = j;
+    }
+    registrySlot[i] = REGISTRY_EMPTY;
+}
+
+/*
+* Function: findTasksByName()
+* collects the live tasks with the given name (case insensitive), returns how many
+*/
+uint8_t findTasksByName(const char name[], TCB *found[MAX_TASKS])
+{
+    uint32_t hash = nameHash(name);
+    uint8_t i, count = 0;
+    TCB *task;
+    uint32_t irqState = _disable_interrupts();
+
+    for (i = hash & (REGISTRY_SLOTS - 1); registrySlot[i] != REGISTRY_EMPTY; i = (i + 1) & (REGISTRY_SLOTS - 1))
+    {
+        task = &tcb[registrySlot[i] - 1];
+        if (registryHash[i] == hash && stringCompare(task->name, name))
+            found[count++] = task;
+    }
+    _restore_interrupts(irqState);
+    return count;
+}
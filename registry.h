@@ -0,0 +1,29 @@
+/*
+ *      Filename: registry.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef REGISTRY_H_
+#define REGISTRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+
+//-----------------------------------------------------------------------------
+// Task Registry Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define REGISTRY_SLOTS          32          // power of two, at least twice MAX_TASKS to keep probes short
+#define REGISTRY_EMPTY          0           // slot holds no task, others hold a tcb index + 1
+
+#define FNV_OFFSET_BASIS        2166136261UL
+#define FNV_PRIME               16777619UL
+
+uint32_t nameHash(const char name[]);
+void registerTask(TCB *task);
+void unregisterTask(TCB *task);
+uint8_t findTasksByName(const char name[], TCB *found[MAX_TASKS]);
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ *      Filename: ring.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Lock-free single producer, single consumer ring buffer
+//
+// One side (typically an interrupt handler) only pushes and the other (a task)
+// only pops, so neither needs a critical section: the producer owns head, the
+// consumer owns tail, and each only reads the other's index. A DMB orders the
+// data accesses against the index update that publishes them - the producer
+// writes the data before it moves head, the consumer reads the data before it
+// moves tail and hands the space back.
+//
+// ringWriteSpan()/ringReadSpan() expose the largest contiguous piece of free or
+// filled buffer so a caller can fill or drain it in place (a DMA transfer or a
+// FIFO loop) and publish it with a single commit.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: initRing()
+* sets up an empty ring over buffer, size must be a power of two
+*/
+bool initRing(RING *r, uint8_t buffer[], uint32_t size)
+{
+    if (size == 0 || (size & (size - 1)) != 0)
+        return false;
+
+    r->buffer = buffer;
+    r->mask = size - 1;
+    r->head = 0;
+    r->tail = 0;
+    return true;
+}
+
+/*
+* Function: ringCount()
+* bytes waiting to be popped
+*/
+uint32_t ringCount(RING *r)
+{
+    return r->head - r->tail;
+}
+
+/*
+* Function: ringFree()
+* bytes that can be pushed
+*/
+uint32_t ringFree(RING *r)
+{
+    return r->mask + 1 - (r->head - r->tail);
+}
+
+/*
+* Function: ringPush()
+* producer: appends one byte, false if the ring is full
+*/
+bool ringPush(RING *r, uint8_t data)
+{
+    uint32_t head = r->head;
+
+    if (head - r->tail > r->mask)
+        return false;
+    r->buffer[head & r->mask] = data;
+    DMB();                                  // data is visible before head publishes it
+    r->head = head + 1;
+    return true;
+}
+
+/*
+* Function: ringPop()
+* consumer: removes one byte, false if the ring is empty
+*/
+bool ringPop(RING *r, uint8_t *data)
+{
+    uint32_t tail = r->tail;
+
+    if (r->head == tail)
+        return false;
+    DMB();                                  // head was read before the data it covers
+    *data = r->buffer[tail & r->mask];
+    DMB();                                  // data is read before tail frees the slot
+    r->tail = tail + 1;
+    return true;
+}
+
+/*
+* Function: ringWriteSpan()
+* producer: points span at the largest contiguous free area and returns its length
+*/
+uint32_t ringWriteSpan(RING *r, uint8_t **span)
+{
+    uint32_t head = r->head;
+    uint32_t free = r->mask + 1 - (head - r->tail);
+    uint32_t toEnd = r->mask + 1 - (head & r->mask);
+
+    DMB();                                  // tail was read before the space is reused
+    *span = &r->buffer[head & r->mask];
+    return free < toEnd ? free : toEnd;
+}
+
+/*
+* Function: ringCommitWrite()
+* producer: publishes length bytes written into the span from ringWriteSpan()
+*/
+void ringCommitWrite(RING *r, uint32_t length)
+{
+    DMB();
+    r->head += length;
+}
+
+/*
+* Function: ringReadSpan()
+* consumer: points span at the largest contiguous filled area and returns its length
+*/
+uint32_t ringReadSpan(RING *r, uint8_t **span)
+{
+    uint32_t tail = r->tail;
+    uint32_t count = r->head - tail;
+    uint32_t toEnd = r->mask + 1 - (tail & r->mask);
+
+    DMB();
+    *span = &r->buffer[tail & r->mask];
+    return count < toEnd ? count : toEnd;
+}
+
+/*
+* Function: ringCommitRead()
+* consumer: hands length bytes of the span from ringReadSpan() back to the producer
+*/
+void ringCommitRead(RING *r, uint32_t length)
+{
+    DMB();
+    r->tail += length;
+}
+
+/*
+* Function: ringPushSpan()
+* producer: copies up to length bytes in (at most two contiguous pieces), returns the number copied
+*/
+uint32_t ringPushSpan(RING *r, const uint8_t data[], uint32_t length)
+{
+    uint8_t *span;
+    uint32_t copied = 0;
+    uint32_t n, i;
+
+    while (copied < length && (n = ringWriteSpan(r, &span)) != 0)
+    {
+        if (n > length - copied)
+            n = length - copied;
+        for (i = 0; i < n; i++)
+            span[i] = data[copied + i];
+        ringCommitWrite(r, n);
+        copied += n;
+    }
+    return copied;
+}
+
+/*
+* Function: ringPopSpan()
+* consumer: copies up to length bytes out (at most two contiguous pieces), returns the number copied
+*/
+uint32_t ringPopSpan(RING *r, uint8_t data[], uint32_t length)
+{
+    uint8_t *span;
+    uint32_t copied = 0;
+    uint32_t n, i;
+
+    while (copied < length && (n = ringReadSpan(r, &span)) != 0)
+    {
+        if (n > length - copied)
+            n = length - copied;
+        for (i = 0; i < n; i++)
+            data[copied + i] = span[i];
+        ringCommitRead(r, n);
+        copied += n;
+    }
+    return copied;
+}
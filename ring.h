@@ -0,0 +1,47 @@
+/*
+ *      Filename: ring.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef RING_H_
+#define RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Ring Buffer Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+// data memory barrier, also keeps the compiler from moving memory accesses across it
+// (a host build of ring.c defines it beforehand, e.g. as __sync_synchronize())
+#ifndef DMB
+#define DMB()                   __asm("    DMB")
+#endif
+
+// single producer, single consumer byte ring
+// head is only written by the producer and tail only by the consumer; both run freely
+// and wrap at 2^32, the buffer position is the index masked by (size - 1)
+typedef struct _RING
+{
+    uint8_t *buffer;
+    uint32_t mask;                          // size - 1, size is a power of two
+    volatile uint32_t head;                 // total bytes pushed
+    volatile uint32_t tail;                 // total bytes popped
+} RING;
+
+bool initRing(RING *r, uint8_t buffer[], uint32_t size);
+uint32_t ringCount(RING *r);
+uint32_t ringFree(RING *r);
+bool ringPush(RING *r, uint8_t data);
+bool ringPop(RING *r, uint8_t *data);
+uint32_t ringPushSpan(RING *r, const uint8_t data[], uint32_t length);
+uint32_t ringPopSpan(RING *r, uint8_t data[], uint32_t length);
+uint32_t ringWriteSpan(RING *r, uint8_t **span);
+void ringCommitWrite(RING *r, uint32_t length);
+uint32_t ringReadSpan(RING *r, uint8_t **span);
+void ringCommitRead(RING *r, uint32_t length);
+
+#endif
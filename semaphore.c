@@ -0,0 +1,137 @@
+/*
+ *      Filename: semaphore.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Counting semaphores
+//
+// Waiters queue in priority order (FIFO among equals) and a post hands the count
+// straight to the first of them, so a post never walks a list and is safe from
+// interrupt handlers. A wait can give up after a timeout; the task's TCB.timeout
+// timer then sits on the timing wheel while the task sits on the wait queue, and
+// whichever fires first wakes it and takes it off the other.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tm4c123gh6pm.h"
+#include "kernel.h"
+#include "semaphore.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+SEMAPHORE semaphores[MAX_SEMAPHORES];
+SLAB semaphorePool = SLAB_INIT("semaphores", semaphores, SEMAPHORE, waiters);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: createSemaphore()
+* returns the handle of a new semaphore with the given initial count, INVALID_SEMAPHORE if none is free
+*/
+uint8_t createSemaphore(const char name[], uint32_t count)
+{
+    uint8_t i, j;
+    SEMAPHORE *object;
+    uint32_t irqState = _disable_interrupts();
+
+    object = slabAlloc(&semaphorePool);
+    if (object == 0)
+    {
+        _restore_interrupts(irqState);
+        return INVALID_SEMAPHORE;
+    }
+    i = slabIndex(&semaphorePool, object);
+
+    semaphores[i].valid = true;
+    semaphores[i].count = count;
+    semaphores[i].waiters = 0;
+    semaphores[i].posts = 0;
+    semaphores[i].waits = 0;
+    semaphores[i].timeouts = 0;
+    for (j = 0; j < MAX_SEMAPHORE_NAME_LENGTH && name[j] != 0; j++)
+        semaphores[i].name[j] = name[j];
+    semaphores[i].name[j] = 0;
+
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: waitSemaphore()
+* takes one count, blocking for up to timeoutMs (NO_WAIT, WAIT_FOREVER) while it is zero
+* returns false on timeout or for an invalid handle, task context only
+*/
+bool waitSemaphore(uint8_t semaphore, uint32_t timeoutMs)
+{
+    SEMAPHORE *s = &semaphores[semaphore];
+    uint32_t irqState;
+
+    if (semaphore >= MAX_SEMAPHORES || !s->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    s->waits++;
+    if (s->count > 0)
+    {
+        s->count--;
+        _restore_interrupts(irqState);
+        return true;
+    }
+    if (timeoutMs == NO_WAIT)
+    {
+        s->timeouts++;
+        _restore_interrupts(irqState);
+        return false;
+    }
+
+    if (timeoutMs == WAIT_FOREVER)
+        blockCurrentTask(&s->waiters, s);
+    else
+        blockCurrentTaskTimeout(&s->waiters, s, msToTicks(timeoutMs));
+    _restore_interrupts(irqState);
+
+    // runs again once postSemaphore() handed over the count or the timeout expired
+    if (taskCurrent->timedOut)
+    {
+        irqState = _disable_interrupts();
+        s->timeouts++;
+        _restore_interrupts(irqState);
+        return false;
+    }
+    return true;
+}
+
+/*
+* Function: postSemaphore()
+* gives one count to the highest priority waiter, or adds it to the semaphore if nobody waits
+* may be called from interrupt handlers
+*/
+bool postSemaphore(uint8_t semaphore)
+{
+    SEMAPHORE *s = &semaphores[semaphore];
+    TCB *next;
+    uint32_t irqState;
+
+    if (semaphore >= MAX_SEMAPHORES || !s->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    s->posts++;
+    next = s->waiters;
+    if (next)
+    {
+        waitQueueRemove(&s->waiters, next);
+        readyTask(next);
+    }
+    else
+        s->count++;
+    _restore_interrupts(irqState);
+    return true;
+}
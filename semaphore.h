@@ -0,0 +1,43 @@
+/*
+ *      Filename: semaphore.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef SEMAPHORE_H_
+#define SEMAPHORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Semaphore Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_SEMAPHORE_NAME_LENGTH 15
+#define INVALID_SEMAPHORE       0xFF
+
+#define NO_WAIT                 0           // waitSemaphore() timeouts in ms
+#define WAIT_FOREVER            0xFFFFFFFF
+
+typedef struct _SEMAPHORE
+{
+    bool valid;
+    uint32_t count;
+    TCB *waiters;                           // blocked tasks, highest priority first
+    char name[MAX_SEMAPHORE_NAME_LENGTH + 1];
+    uint32_t posts;                         // postSemaphore() calls
+    uint32_t waits;                         // waitSemaphore() calls
+    uint32_t timeouts;                      // waits that gave up
+} SEMAPHORE;
+
+extern SEMAPHORE semaphores[MAX_SEMAPHORES];
+extern SLAB semaphorePool;
+
+uint8_t createSemaphore(const char name[], uint32_t count);
+bool waitSemaphore(uint8_t semaphore, uint32_t timeoutMs);
+bool postSemaphore(uint8_t semaphore);
+
+#endif
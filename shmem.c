@@ -0,0 +1,208 @@
+/*
+ *      Filename: shmem.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Named shared memory
+//
+// A segment is a kernel-owned heap block, rounded up to a power of two and
+// aligned to its size, that tasks attach by handle. Once attached, a task
+// reaches it with plain loads and stores; the kernel is only involved in
+// attach and detach. A read-write attach adds the segment's subregions to the
+// task's SRAM access mask. A read-only attach cannot use the mask, which only
+// grants RW, so it declares an MPU window instead: the subregions stay disabled
+// for the task and fall through to the read-only window region.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "shmem.h"
+#include "heap.h"
+#include "mpu.h"
+#include "terminal.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+SHARED_MEMORY segments[MAX_SHARED_MEMORY];
+SLAB segmentPool = SLAB_INIT("shmem", segments, SHARED_MEMORY, base);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: attachment()
+* slot of a task in a segment's attachment list, MAX_SHM_ATTACHMENTS if it is not attached
+*/
+static uint8_t attachment(SHARED_MEMORY *m, uint32_t pid)
+{
+    uint8_t i;
+
+    for (i = 0; i < m->attachments && m->pid[i] != pid; i++);
+    return i < m->attachments ? i : MAX_SHM_ATTACHMENTS;
+}
+
+/*
+* Function: createSharedMemory()
+* returns the handle of a new zeroed segment of at least size bytes, INVALID_SHARED_MEMORY
+* if the name is taken, no segment is free or the heap has no aligned run for it (at most 8KiB)
+*/
+uint8_t createSharedMemory(const char name[], uint32_t size)
+{
+    SHARED_MEMORY *object;
+    uint8_t *base;
+    uint8_t i, j;
+    uint32_t k;
+    uint32_t irqState;
+
+    base = heapAllocate(size, 0, HEAP_ALIGNED | HEAP_SPAN_REGIONS);
+    if (base == 0)
+        return INVALID_SHARED_MEMORY;
+    size = heapBlockSize(base);
+    for (k = 0; k < size; k++)
+        base[k] = 0;
+
+    // the name is looked up and claimed in one critical section, so two creators cannot both register it
+    irqState = _disable_interrupts();
+    if (findSharedMemory(name) != INVALID_SHARED_MEMORY || (object = slabAlloc(&segmentPool)) == 0)
+    {
+        _restore_interrupts(irqState);
+        heapRelease(base, 0);
+        return INVALID_SHARED_MEMORY;
+    }
+    i = slabIndex(&segmentPool, object);
+
+    segments[i].base = base;
+    segments[i].size = size;
+    segments[i].attachments = 0;
+    for (j = 0; j < MAX_SHM_NAME_LENGTH && name[j] != 0; j++)
+        segments[i].name[j] = name[j];
+    segments[i].name[j] = 0;
+    segments[i].valid = true;
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: findSharedMemory()
+* handle of the segment with the given name, INVALID_SHARED_MEMORY if there is none
+*/
+uint8_t findSharedMemory(const char name[])
+{
+    uint8_t i;
+
+    for (i = 0; i < MAX_SHARED_MEMORY; i++)
+        if (segments[i].valid && stringCompare(segments[i].name, name))
+            return i;
+    return INVALID_SHARED_MEMORY;
+}
+
+/*
+* Function: attachSharedMemory()
+* maps a segment into the running task, read-write or read-only, and returns its address
+* returns 0 for an invalid handle, a full attachment list or no free window
+*/
+void *attachSharedMemory(uint8_t segment, bool writable)
+{
+    SHARED_MEMORY *m = &segments[segment];
+    uint32_t irqState;
+    uint8_t i;
+
+    if (segment >= MAX_SHARED_MEMORY || !m->valid || attachment(m, taskCurrent->pid) < MAX_SHM_ATTACHMENTS ||
+        m->attachments == MAX_SHM_ATTACHMENTS)
+        return 0;
+
+    if (writable)
+    {
+        irqState = _disable_interrupts();
+        addSramAccessWindow(&taskCurrent->srd, (uint32_t *) m->base, m->size);
+        if (getMpuIsolation())
+            applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+        _restore_interrupts(irqState);
+    }
+    else if (!addTaskWindow((uint32_t) m->base, m->size, false))
+        return 0;
+
+    i = m->attachments++;
+    m->pid[i] = taskCurrent->pid;
+    m->writable[i] = writable;
+    return m->base;
+}
+
+/*
+* Function: detachSharedMemory()
+* unmaps a segment from the running task
+*/
+bool detachSharedMemory(uint8_t segment)
+{
+    SHARED_MEMORY *m = &segments[segment];
+    uint32_t irqState;
+    uint8_t i;
+
+    if (segment >= MAX_SHARED_MEMORY || !m->valid)
+        return false;
+    i = attachment(m, taskCurrent->pid);
+    if (i == MAX_SHM_ATTACHMENTS)
+        return false;
+
+    if (m->writable[i])
+    {
+        irqState = _disable_interrupts();
+        removeSramAccessWindow(&taskCurrent->srd, (uint32_t *) m->base, m->size);
+        if (getMpuIsolation())
+            applySramRegionTable(&taskCurrent->mpuTable, taskCurrent->srd);
+        _restore_interrupts(irqState);
+    }
+    else
+        removeTaskWindow((uint32_t) m->base);
+
+    m->attachments--;
+    m->pid[i] = m->pid[m->attachments];
+    m->writable[i] = m->writable[m->attachments];
+    return true;
+}
+
+/*
+* Function: detachTaskSegments()
+* drops a task that is being killed from the attachment lists, its MPU state goes with it
+* must be called with interrupts disabled
+*/
+void detachTaskSegments(uint32_t pid)
+{
+    SHARED_MEMORY *m;
+    uint8_t i;
+
+    for (m = segments; m < segments + MAX_SHARED_MEMORY; m++)
+    {
+        if (!m->valid || (i = attachment(m, pid)) == MAX_SHM_ATTACHMENTS)
+            continue;
+        m->attachments--;
+        m->pid[i] = m->pid[m->attachments];
+        m->writable[i] = m->writable[m->attachments];
+    }
+}
+
+/*
+* Function: deleteSharedMemory()
+* returns a segment with no tasks attached to the heap
+*/
+bool deleteSharedMemory(uint8_t segment)
+{
+    SHARED_MEMORY *m = &segments[segment];
+    uint32_t irqState;
+
+    if (segment >= MAX_SHARED_MEMORY || !m->valid || m->attachments)
+        return false;
+
+    heapRelease(m->base, 0);
+    irqState = _disable_interrupts();
+    m->valid = false;
+    slabFree(&segmentPool, m);
+    _restore_interrupts(irqState);
+    return true;
+}
@@ -0,0 +1,44 @@
+/*
+ *      Filename: shmem.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef SHMEM_H_
+#define SHMEM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Shared Memory Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_SHM_NAME_LENGTH     15
+#define MAX_SHM_ATTACHMENTS     4
+#define INVALID_SHARED_MEMORY   0xFF
+
+typedef struct _SHARED_MEMORY
+{
+    bool valid;
+    uint8_t *base;                          // heap block, a power of two aligned to its size
+    uint32_t size;
+    uint8_t attachments;
+    uint32_t pid[MAX_SHM_ATTACHMENTS];      // attached tasks
+    bool writable[MAX_SHM_ATTACHMENTS];     // attached read-write rather than read-only
+    char name[MAX_SHM_NAME_LENGTH + 1];
+} SHARED_MEMORY;
+
+extern SHARED_MEMORY segments[MAX_SHARED_MEMORY];
+extern SLAB segmentPool;
+
+uint8_t createSharedMemory(const char name[], uint32_t size);
+uint8_t findSharedMemory(const char name[]);
+void *attachSharedMemory(uint8_t segment, bool writable);
+bool detachSharedMemory(uint8_t segment);
+void detachTaskSegments(uint32_t pid);
+bool deleteSharedMemory(uint8_t segment);
+
+#endif
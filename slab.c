@@ -0,0 +1,79 @@
+/*
+ *      Filename: slab.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Fixed-size pools for kernel objects
+//
+// Each kind of kernel object (tasks, mutexes, semaphores, queues, event groups,
+// timers) lives in a static array sized in config.h, so objects never come from
+// the heap and cannot fragment it. Objects that were never used are handed out
+// in array order; freed ones go on a free list threaded through a pointer field
+// of the free objects themselves. Both allocation and release are O(1), and an
+// object's index in its array is its handle.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: slabLink()
+* free list link field of an object
+*/
+static void **slabLink(const SLAB *slab, void *object)
+{
+    return (void **) ((uint8_t *) object + slab->link);
+}
+
+/*
+* Function: slabAlloc()
+* takes an object from the pool, 0 if it is full; the caller clears the interrupts around it
+*/
+void *slabAlloc(SLAB *slab)
+{
+    void *object;
+
+    if (slab->freeList)
+    {
+        object = slab->freeList;
+        slab->freeList = *slabLink(slab, object);
+    }
+    else if (slab->fresh < slab->capacity)
+        object = slab->objects + slab->size * slab->fresh++;
+    else
+    {
+        slab->failures++;
+        return 0;
+    }
+
+    if (++slab->used > slab->peak)
+        slab->peak = slab->used;
+    return object;
+}
+
+/*
+* Function: slabFree()
+* returns an object to the pool; the caller clears the interrupts around it
+*/
+void slabFree(SLAB *slab, void *object)
+{
+    *slabLink(slab, object) = slab->freeList;
+    slab->freeList = object;
+    slab->used--;
+}
+
+/*
+* Function: slabIndex()
+* position of an object in the pool's array, its handle
+*/
+uint8_t slabIndex(const SLAB *slab, const void *object)
+{
+    return ((const uint8_t *) object - slab->objects) / slab->size;
+}
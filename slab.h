@@ -0,0 +1,44 @@
+/*
+ *      Filename: slab.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef SLAB_H_
+#define SLAB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "config.h"
+
+//-----------------------------------------------------------------------------
+// Slab Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+// pool of fixed-size objects over a static array; a free object holds the link to
+// the next free one in a pointer field (link) that is unused while the object is free
+typedef struct _SLAB
+{
+    const char *name;
+    uint8_t *objects;                       // the array the objects are taken from
+    uint16_t size;                          // bytes per object
+    uint16_t link;                          // offset of the free list link in an object
+    uint8_t capacity;                       // objects in the array
+    uint8_t fresh;                          // objects handed out at least once, in array order
+    uint8_t used;                           // objects allocated now
+    uint8_t peak;                           // most objects allocated at once
+    void *freeList;                         // freed objects, most recently freed first
+    uint32_t failures;                      // allocations refused because the pool was full
+} SLAB;
+
+// static initializer of the pool over array[], an array of type with a pointer field link
+#define SLAB_INIT(name, array, type, link) \
+    {name, (uint8_t *) (array), sizeof(type), offsetof(type, link), sizeof(array) / sizeof(type), 0, 0, 0, 0, 0}
+
+void *slabAlloc(SLAB *slab);
+void slabFree(SLAB *slab, void *object);
+uint8_t slabIndex(const SLAB *slab, const void *object);
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ *      Filename: syscall.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// System call table
+//
+// svCallISR (syscall_s.s) reads the immediate of the SVC instruction through
+// the stacked PC, calls svcTable[immediate] with a pointer to the stacked
+// R0-R3 and writes the result back into the stacked R0, which is what the
+// stub returns once the exception unwinds. Calls that block (sleep, a
+// contended mutex) only pend the switch, which tail-chains into PendSV when
+// the SVC returns.
+//
+// A handler that blocks returns before the outcome of its call is known, so it
+// leaves a resume function in the caller's TCB (svcResume) and taskSwitch()
+// writes what that function returns into the stacked R0 when the caller runs
+// again. Names passed through the gate must be string literals: a pointer
+// outside flash is refused, so the kernel never copies out memory the caller
+// could not read itself.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "syscall.h"
+#include "mutex.h"
+#include "semaphore.h"
+#include "eventflags.h"
+#include "msgqueue.h"
+#include "shmem.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#define FLASH_SIZE              0x00040000  // names must lie below, see userName()
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: userName()
+* true if a name passed by an unprivileged caller is a literal in flash
+*/
+static bool userName(uint32_t name)
+{
+    return name < FLASH_SIZE;
+}
+
+/*
+* Function: sendResult()
+* outcome of a send that blocked, taken by taskSwitch() when the sender runs again
+*/
+static uint32_t sendResult(TCB *task)
+{
+    return !task->timedOut;
+}
+
+/*
+* Function: receiveResult()
+* message handed to a receiver that blocked, 0 after a timeout
+*/
+static uint32_t receiveResult(TCB *task)
+{
+    return task->timedOut ? 0 : (uint32_t) task->waitData;
+}
+
+//-----------------------------------------------------------------------------
+// Handlers
+//-----------------------------------------------------------------------------
+
+static uint32_t sysNull(uint32_t args[])
+{
+    return 0;
+}
+
+static uint32_t sysYield(uint32_t args[])
+{
+    yield();
+    return 0;
+}
+
+static uint32_t sysSleep(uint32_t args[])
+{
+    sleep(args[0]);
+    return 0;
+}
+
+static uint32_t sysGetPid(uint32_t args[])
+{
+    return taskCurrent->pid;
+}
+
+static uint32_t sysLockMutex(uint32_t args[])
+{
+    return lockMutex(args[0]);
+}
+
+static uint32_t sysUnlockMutex(uint32_t args[])
+{
+    return unlockMutex(args[0]);
+}
+
+static uint32_t sysPostSemaphore(uint32_t args[])
+{
+    return postSemaphore(args[0]);
+}
+
+static uint32_t sysSetEventFlags(uint32_t args[])
+{
+    return setEventFlags(args[0], args[1]);
+}
+
+static uint32_t sysWaitNextPeriod(uint32_t args[])
+{
+    waitNextPeriod();
+    return 0;
+}
+
+static uint32_t sysAllocMessage(uint32_t args[])
+{
+    return (uint32_t) allocMessage();
+}
+
+static uint32_t sysFreeMessage(uint32_t args[])
+{
+    return freeMessage((void *) args[0]);
+}
+
+static uint32_t sysExit(uint32_t args[])
+{
+    stopCurrentThread();
+    yield();
+    return 0;
+}
+
+static uint32_t sysCreateQueue(uint32_t args[])
+{
+    if (!userName(args[0]))
+        return INVALID_QUEUE;
+    return createQueue((const char *) args[0], args[1]);
+}
+
+static uint32_t sysFindQueue(uint32_t args[])
+{
+    if (!userName(args[0]))
+        return INVALID_QUEUE;
+    return findQueue((const char *) args[0]);
+}
+
+// interrupts stay off until the handler knows whether the call blocked, so a wake-up from an
+// interrupt handler cannot slip in between
+static uint32_t sysSendMessage(uint32_t args[])
+{
+    uint32_t irqState = _disable_interrupts();
+    bool sent = sendMessage(args[0], (void *) args[1], args[2], args[3]);
+
+    if (taskCurrent->state == STATE_BLOCKED)
+        taskCurrent->svcResume = sendResult;
+    _restore_interrupts(irqState);
+    return sent;
+}
+
+static uint32_t sysReceiveMessage(uint32_t args[])
+{
+    uint32_t irqState = _disable_interrupts();
+    void *message = receiveMessage(args[0], 0, args[1]);
+
+    if (taskCurrent->state == STATE_BLOCKED)
+        taskCurrent->svcResume = receiveResult;
+    _restore_interrupts(irqState);
+    return (uint32_t) message;
+}
+
+static uint32_t sysMessageLength(uint32_t args[])
+{
+    return messageLength((void *) args[0]);
+}
+
+static uint32_t sysCreateSharedMemory(uint32_t args[])
+{
+    if (!userName(args[0]))
+        return INVALID_SHARED_MEMORY;
+    return createSharedMemory((const char *) args[0], args[1]);
+}
+
+static uint32_t sysFindSharedMemory(uint32_t args[])
+{
+    if (!userName(args[0]))
+        return INVALID_SHARED_MEMORY;
+    return findSharedMemory((const char *) args[0]);
+}
+
+static uint32_t sysAttachSharedMemory(uint32_t args[])
+{
+    return (uint32_t) attachSharedMemory(args[0], args[1]);
+}
+
+static uint32_t sysDetachSharedMemory(uint32_t args[])
+{
+    return detachSharedMemory(args[0]);
+}
+
+//-----------------------------------------------------------------------------
+// Table, in flash, indexed by the SVC immediate
+//-----------------------------------------------------------------------------
+
+const svcHandler svcTable[SVC_COUNT] =
+{
+    sysNull,                                // SVC_NULL
+    sysYield,                               // SVC_YIELD
+    sysSleep,                               // SVC_SLEEP
+    sysGetPid,                              // SVC_GET_PID
+    sysLockMutex,                           // SVC_LOCK_MUTEX
+    sysUnlockMutex,                         // SVC_UNLOCK_MUTEX
+    sysPostSemaphore,                       // SVC_POST_SEMAPHORE
+    sysSetEventFlags,                       // SVC_SET_EVENT_FLAGS
+    sysWaitNextPeriod,                      // SVC_WAIT_NEXT_PERIOD
+    sysAllocMessage,                        // SVC_ALLOC_MESSAGE
+    sysFreeMessage,                         // SVC_FREE_MESSAGE
+    sysExit,                                // SVC_EXIT
+    sysCreateQueue,                         // SVC_CREATE_QUEUE
+    sysFindQueue,                           // SVC_FIND_QUEUE
+    sysSendMessage,                         // SVC_SEND_MESSAGE
+    sysReceiveMessage,                      // SVC_RECEIVE_MESSAGE
+    sysMessageLength,                       // SVC_MESSAGE_LENGTH
+    sysCreateSharedMemory,                  // SVC_CREATE_SHARED_MEMORY
+    sysFindSharedMemory,                    // SVC_FIND_SHARED_MEMORY
+    sysAttachSharedMemory,                  // SVC_ATTACH_SHARED_MEMORY
+    sysDetachSharedMemory                   // SVC_DETACH_SHARED_MEMORY
+};
+
+const uint32_t svcCount = SVC_COUNT;
@@ -0,0 +1,77 @@
+/*
+ *      Filename: syscall.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef SYSCALL_H_
+#define SYSCALL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// System Call Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+// SVC immediates, the stubs in syscall_s.s use the same numbers
+typedef enum _svc_number_
+{
+    SVC_NULL,                               // does nothing, measures the gate
+    SVC_YIELD,
+    SVC_SLEEP,
+    SVC_GET_PID,
+    SVC_LOCK_MUTEX,
+    SVC_UNLOCK_MUTEX,
+    SVC_POST_SEMAPHORE,
+    SVC_SET_EVENT_FLAGS,
+    SVC_WAIT_NEXT_PERIOD,
+    SVC_ALLOC_MESSAGE,
+    SVC_FREE_MESSAGE,
+    SVC_EXIT,
+    SVC_CREATE_QUEUE,
+    SVC_FIND_QUEUE,
+    SVC_SEND_MESSAGE,
+    SVC_RECEIVE_MESSAGE,
+    SVC_MESSAGE_LENGTH,
+    SVC_CREATE_SHARED_MEMORY,
+    SVC_FIND_SHARED_MEMORY,
+    SVC_ATTACH_SHARED_MEMORY,
+    SVC_DETACH_SHARED_MEMORY,
+    SVC_COUNT
+} svcNumber;
+
+#define SVC_INVALID_RESULT      0xFFFFFFFF  // returned for an immediate without a handler
+
+// handler of one system call, args points at the stacked R0-R3 of the caller
+typedef uint32_t (*svcHandler)(uint32_t args[]);
+
+extern const svcHandler svcTable[SVC_COUNT];
+extern const uint32_t svcCount;
+
+/* System call stubs (syscall_s.s), callable from unprivileged threads */
+void svCallISR(void);
+uint32_t svcNull(void);
+void svcYield(void);
+void svcSleep(uint32_t ms);
+uint32_t svcGetPid(void);
+bool svcLockMutex(uint8_t mutex);
+bool svcUnlockMutex(uint8_t mutex);
+bool svcPostSemaphore(uint8_t semaphore);
+bool svcSetEventFlags(uint8_t group, uint32_t mask);
+void svcWaitNextPeriod(void);
+void *svcAllocMessage(void);
+bool svcFreeMessage(void *message);
+void svcExit(void);
+uint8_t svcCreateQueue(const char name[], uint8_t depth);
+uint8_t svcFindQueue(const char name[]);
+bool svcSendMessage(uint8_t queue, void *message, uint16_t length, uint32_t timeoutMs);
+void *svcReceiveMessage(uint8_t queue, uint32_t timeoutMs);
+uint16_t svcMessageLength(void *message);
+uint8_t svcCreateSharedMemory(const char name[], uint32_t size);
+uint8_t svcFindSharedMemory(const char name[]);
+void *svcAttachSharedMemory(uint8_t segment, bool writable);
+bool svcDetachSharedMemory(uint8_t segment);
+
+#endif
@@ -0,0 +1,153 @@
+; System call gate
+
+	.def svCallISR
+	.def svcNull
+	.def svcYield
+	.def svcSleep
+	.def svcGetPid
+	.def svcLockMutex
+	.def svcUnlockMutex
+	.def svcPostSemaphore
+	.def svcSetEventFlags
+	.def svcWaitNextPeriod
+	.def svcAllocMessage
+	.def svcFreeMessage
+	.def svcExit
+	.def svcCreateQueue
+	.def svcFindQueue
+	.def svcSendMessage
+	.def svcReceiveMessage
+	.def svcMessageLength
+	.def svcCreateSharedMemory
+	.def svcFindSharedMemory
+	.def svcAttachSharedMemory
+	.def svcDetachSharedMemory
+	.ref svcTable
+	.ref svcCount
+
+
+.thumb
+.const
+
+.text
+
+; SVCall handler - dispatches on the immediate of the SVC instruction
+; the caller's R0-R3 are on the stack it used when the exception was taken, the
+; handler gets a pointer to them in R0 and its return value replaces the stacked R0
+svCallISR:
+			TST		LR, #0x4					; EXC_RETURN bit 2 set: the caller used the PSP
+			ITE		EQ
+			MRSEQ	R0, MSP
+			MRSNE	R0, PSP
+			LDR		R1, [R0, #24]				; stacked PC, points after the SVC instruction
+			LDRB	R1, [R1, #-2]				; immediate, low byte of the SVC instruction
+			LDR		R2, svcCountAddr
+			LDR		R2, [R2]
+			CMP		R1, R2
+			BHS		svcInvalid
+			LDR		R2, svcTableAddr
+			LDR		R2, [R2, R1, LSL #2]		; handler for the immediate
+			PUSH	{R0, LR}					; keeps the frame address and EXC_RETURN
+			BLX		R2							; R0 = handler(frame)
+			POP		{R1, LR}
+			STR		R0, [R1]					; result into the stacked R0
+			BX		LR
+svcInvalid:
+			MVN		R1, #0
+			STR		R1, [R0]					; unknown call returns SVC_INVALID_RESULT
+			BX		LR
+
+; stubs - arguments are already in R0-R3 and the result comes back in R0,
+; the numbers match svcNumber in syscall.h
+svcNull:
+			SVC		#0
+			BX		LR
+
+svcYield:
+			SVC		#1
+			BX		LR
+
+svcSleep:
+			SVC		#2
+			BX		LR
+
+svcGetPid:
+			SVC		#3
+			BX		LR
+
+svcLockMutex:
+			SVC		#4
+			BX		LR
+
+svcUnlockMutex:
+			SVC		#5
+			BX		LR
+
+svcPostSemaphore:
+			SVC		#6
+			BX		LR
+
+svcSetEventFlags:
+			SVC		#7
+			BX		LR
+
+svcWaitNextPeriod:
+			SVC		#8
+			BX		LR
+
+svcAllocMessage:
+			SVC		#9
+			BX		LR
+
+svcFreeMessage:
+			SVC		#10
+			BX		LR
+
+svcExit:
+			SVC		#11
+			BX		LR
+
+svcCreateQueue:
+			SVC		#12
+			BX		LR
+
+svcFindQueue:
+			SVC		#13
+			BX		LR
+
+svcSendMessage:
+			SVC		#14
+			BX		LR
+
+svcReceiveMessage:
+			SVC		#15
+			BX		LR
+
+svcMessageLength:
+			SVC		#16
+			BX		LR
+
+svcCreateSharedMemory:
+			SVC		#17
+			BX		LR
+
+svcFindSharedMemory:
+			SVC		#18
+			BX		LR
+
+svcAttachSharedMemory:
+			SVC		#19
+			BX		LR
+
+svcDetachSharedMemory:
+			SVC		#20
+			BX		LR
+
+			.align	4
+svcTableAddr:
+			.word	svcTable
+svcCountAddr:
+			.word	svcCount
+
+
+.end
@@ -0,0 +1,265 @@
+/*
+ *      Filename: tasks.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Built-in programs started with "run <name>"
+//
+// The periodic programs stand in for sampling, control and telemetry loops:
+// each job burns its declared execution time and then waits for its next
+// period. Their priorities are assigned rate monotonically (shorter period,
+// higher priority) above the shell, aperiodic programs run below the shell.
+//
+// Programs run unprivileged (createUserThread()) and call the kernel only
+// through the svc stubs. The LEDs are outside a task's SRAM, so a program that
+// drives them is given the port F bit-band window by its table entry: the
+// kernel declares it when the task is created, and with MPU isolation on the
+// first LED write faults it in. Programs cannot declare windows themselves.
+//
+// framer and sink pass 256-byte frames through the "frames" queue without
+// copying them: each send moves the block's subregions from the framer to the
+// sink. publisher and watcher share the "status" segment: the publisher
+// attaches it read-write through its access mask, the watcher read-only through
+// a window. The intruder writes a message block after returning it to the
+// pool, which with isolation on stops it.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tasks.h"
+#include "kernel.h"
+#include "syscall.h"
+#include "semaphore.h"
+#include "msgqueue.h"
+#include "shmem.h"
+#include "terminal.h"
+#include "registry.h"
+#include "onboard_leds.h"
+#include "wait.h"
+
+//-----------------------------------------------------------------------------
+// Programs
+//-----------------------------------------------------------------------------
+
+#define FRAME_BYTES             256
+#define FRAME_WORDS             (FRAME_BYTES / sizeof(uint32_t))
+#define STATUS_BYTES            512
+
+static void flash4Hz(void)
+{
+    while (1)
+    {
+        GREEN_LED ^= 1;
+        svcWaitNextPeriod();
+    }
+}
+
+static void sampler(void)
+{
+    while (1)
+    {
+        waitMicrosecond(2000);
+        svcWaitNextPeriod();
+    }
+}
+
+static void control(void)
+{
+    while (1)
+    {
+        waitMicrosecond(5000);
+        svcWaitNextPeriod();
+    }
+}
+
+static void telemetry(void)
+{
+    while (1)
+    {
+        waitMicrosecond(10000);
+        svcWaitNextPeriod();
+    }
+}
+
+static void load(void)
+{
+    while (1)
+    {
+        waitMicrosecond(20000);
+        svcWaitNextPeriod();
+    }
+}
+
+static void logger(void)
+{
+    while (1)
+    {
+        BLUE_LED ^= 1;
+        svcSleep(1000);
+    }
+}
+
+static void framer(void)
+{
+    uint8_t queue = svcCreateQueue("frames", 4);
+    uint32_t *frame;
+    uint32_t sequence = 0;
+    uint8_t i;
+
+    if (queue == INVALID_QUEUE && (queue = svcFindQueue("frames")) == INVALID_QUEUE)
+        return;
+    while (1)
+    {
+        frame = svcAllocMessage();
+        if (frame)
+        {
+            for (i = 0; i < FRAME_WORDS; i++)
+                frame[i] = sequence + i;
+            sequence++;
+            if (!svcSendMessage(queue, frame, FRAME_BYTES, WAIT_FOREVER))
+                svcFreeMessage(frame);
+        }
+        svcSleep(100);
+    }
+}
+
+static void sink(void)
+{
+    uint8_t queue;
+    uint32_t *frame;
+    uint8_t i;
+
+    while ((queue = svcFindQueue("frames")) == INVALID_QUEUE)
+        svcSleep(100);
+    while (1)
+    {
+        // the frame is read in place, it became this task's block when it was received
+        frame = svcReceiveMessage(queue, WAIT_FOREVER);
+        if (frame == 0)
+            continue;
+        for (i = 1; i < FRAME_WORDS && frame[i] == frame[0] + i; i++);
+        if (i == FRAME_WORDS && svcMessageLength(frame) == FRAME_BYTES)
+            RED_LED ^= 1;
+        svcFreeMessage(frame);
+    }
+}
+
+static void publisher(void)
+{
+    uint8_t segment = svcCreateSharedMemory("status", STATUS_BYTES);
+    volatile uint32_t *status;
+
+    if (segment == INVALID_SHARED_MEMORY && (segment = svcFindSharedMemory("status")) == INVALID_SHARED_MEMORY)
+        return;
+    status = svcAttachSharedMemory(segment, true);
+    if (status == 0)
+        return;
+    while (1)
+    {
+        status[0]++;
+        svcSleep(250);
+    }
+}
+
+static void watcher(void)
+{
+    uint8_t segment;
+    volatile const uint32_t *status;
+    uint32_t seen = 0;
+
+    while ((segment = svcFindSharedMemory("status")) == INVALID_SHARED_MEMORY)
+        svcSleep(100);
+    status = svcAttachSharedMemory(segment, false);
+    if (status == 0)
+        return;
+    while (1)
+    {
+        if (status[0] != seen)
+        {
+            seen = status[0];
+            BLUE_LED ^= 1;
+        }
+        svcSleep(50);
+    }
+}
+
+static void intruder(void)
+{
+    volatile uint8_t *message = svcAllocMessage();
+
+    if (message == 0)
+        return;
+    message[0] = 1;
+    svcFreeMessage((void *) message);
+    message[0] = 2;                         // no longer its block, an MPU fault with isolation on
+}
+
+//-----------------------------------------------------------------------------
+// Program table
+//-----------------------------------------------------------------------------
+
+const PROGRAM programs[] =
+{
+    // name         entry       prio    stack   period  deadline    wcet (us)   window base         window size
+    {"flash4hz",    flash4Hz,   6,      512,    125,    0,          100,        LED_WINDOW_BASE,    LED_WINDOW_SIZE},
+    {"sampler",     sampler,    2,      512,    10,     0,          2100,       0,                  0},
+    {"control",     control,    3,      512,    20,     0,          5100,       0,                  0},
+    {"telemetry",   telemetry,  5,      512,    50,     0,          10100,      0,                  0},
+    {"load",        load,       4,      512,    40,     0,          20100,      0,                  0},
+    {"logger",      logger,     10,     512,    0,      0,          0,          LED_WINDOW_BASE,    LED_WINDOW_SIZE},
+    {"intruder",    intruder,   10,     512,    0,      0,          0,          0,                  0},
+    {"framer",      framer,     9,      512,    0,      0,          0,          0,                  0},
+    {"sink",        sink,       9,      512,    0,      0,          0,          LED_WINDOW_BASE,    LED_WINDOW_SIZE},
+    {"publisher",   publisher,  9,      512,    0,      0,          0,          0,                  0},
+    {"watcher",     watcher,    9,      512,    0,      0,          0,          LED_WINDOW_BASE,    LED_WINDOW_SIZE},
+};
+
+const uint8_t programCount = sizeof(programs) / sizeof(programs[0]);
+
+// open addressing table of the programs keyed by nameHash(), filled by initPrograms()
+static uint8_t programSlot[PROGRAM_SLOTS];          // program index + 1, REGISTRY_EMPTY if unused
+static uint32_t programHash[PROGRAM_SLOTS];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: initPrograms()
+* hashes every program name into the lookup table, called once before the shell starts
+*/
+void initPrograms(void)
+{
+    uint32_t hash;
+    uint8_t i, slot;
+
+    for (i = 0; i < programCount; i++)
+    {
+        hash = nameHash(programs[i].name);
+        for (slot = hash & (PROGRAM_SLOTS - 1); programSlot[slot] != REGISTRY_EMPTY; slot = (slot + 1) & (PROGRAM_SLOTS - 1));
+        programSlot[slot] = i + 1;
+        programHash[slot] = hash;
+    }
+}
+
+/*
+* Function: findProgram()
+* returns the program with the given name (case insensitive), or 0
+*/
+const PROGRAM *findProgram(const char name[])
+{
+    uint32_t hash = nameHash(name);
+    const PROGRAM *program;
+    uint8_t slot;
+
+    // the string compare only confirms a hash match
+    for (slot = hash & (PROGRAM_SLOTS - 1); programSlot[slot] != REGISTRY_EMPTY; slot = (slot + 1) & (PROGRAM_SLOTS - 1))
+    {
+        program = &programs[programSlot[slot] - 1];
+        if (programHash[slot] == hash && stringCompare(program->name, name))
+            return program;
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ *      Filename: tasks.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef TASKS_H_
+#define TASKS_H_
+
+#include <stdint.h>
+#include "kernel.h"
+
+//-----------------------------------------------------------------------------
+// Built-in Programs Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+
+#define PROGRAM_SLOTS           32          // power of two, at least twice the number of programs
+
+// a program that can be started from the shell with "run <name>"
+typedef struct _PROGRAM
+{
+    const char *name;
+    _fn entry;
+    uint8_t priority;
+    uint16_t stackBytes;
+    uint16_t periodMs;                      // 0 for programs that are not periodic
+    uint16_t deadlineMs;                    // 0 uses the period
+    uint16_t wcetUs;                        // declared worst case execution time per job
+    uint32_t windowBase;                    // read-write MPU window granted at creation (a peripheral)
+    uint16_t windowSize;                    // 0 for none
+} PROGRAM;
+
+extern const PROGRAM programs[];
+extern const uint8_t programCount;
+
+void initPrograms(void);
+const PROGRAM *findProgram(const char name[]);
+
+#endif
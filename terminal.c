@@ -2,6 +2,19 @@
 #include "terminal.h"
 #include "uart0.h"
 #include "onboard_leds.h"
+#include "kernel.h"
+#include "bench.h"
+#include "mutex.h"
+#include "semaphore.h"
+#include "msgqueue.h"
+#include "eventflags.h"
+#include "timer.h"
+#include "admission.h"
+#include "tasks.h"
+#include "heap.h"
+#include "shmem.h"
+#include "registry.h"
+#include "mpu.h"
 
 // function to store the string of characters received from UART0
 void getsUart0(USER_DATA *d)
@@ -246,9 +259,9 @@ uint32_t hexToInt(char *hex)
 */
 
 /*
-* converts a 32-bit word to hex string and prints it to UART0
+* converts a 32-bit word to hex string and prints it to UART0, without a line break
 */
-void printHex(uint32_t word)
+void printHexWord(uint32_t word)
 {
     uint8_t i;
     
@@ -260,10 +273,18 @@ void printHex(uint32_t word)
         if (nibble <= 9)
             putcUart0(nibble + '0');         // 0-9
         else
-            putcUart0(nibble + 'A');         // A-F
+            putcUart0(nibble - 10 + 'A');    // A-F
         
         word = word << 4;
     }
+}
+
+/*
+* prints a 32-bit word in hex followed by a line break
+*/
+void printHex(uint32_t word)
+{
+    printHexWord(word);
     putsUart0("\n\r");
 }
 
@@ -362,17 +383,69 @@ void startShell()
             }
         }
 
+        else if (isCommand(&data, "mpu", 1))
+        {
+            char *ONOFF = getFieldString(&data, 1);
+            valid = true;
+            if (stringCompare(ONOFF, "on"))
+            {
+                mpu(true);
+            }
+            else if (stringCompare(ONOFF, "off"))
+            {
+                mpu(false);
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+
+        else if (isCommand(&data, "tickless", 1))
+        {
+            char *ONOFF = getFieldString(&data, 1);
+            valid = true;
+            if (stringCompare(ONOFF, "on"))
+            {
+                setTickless(true);
+            }
+            else if (stringCompare(ONOFF, "off"))
+            {
+                setTickless(false);
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+
+        else if (isCommand(&data, "tick", 1))
+        {
+            tick(getFieldInteger(&data, 1));
+            valid = true;
+        }
+
+        else if (isCommand(&data, "quantum", 2))
+        {
+            quantum(getFieldInteger(&data, 1), getFieldInteger(&data, 2));
+            valid = true;
+        }
+
         else if (isCommand(&data, "sched", 1))
         {
             char *scheduling = getFieldString(&data, 1);
             valid = true;
             if (stringCompare(scheduling, "prio"))
             {
-                sched(true);
+                sched(SCHED_PRIO);
             }
             else if (stringCompare(scheduling, "rr"))
             {
-                sched(false);
+                sched(SCHED_RR);
+            }
+            else if (stringCompare(scheduling, "edf"))
+            {
+                sched(SCHED_EDF);
             }
             else
             {
@@ -392,6 +465,12 @@ void startShell()
             valid = true;
         }
 
+        else if (isCommand(&data, "bench", 1))
+        {
+            bench(getFieldString(&data, 1));
+            valid = true;
+        }
+
         else if (isCommand(&data, "reboot", 0))
         {
             valid = true;
@@ -404,54 +483,434 @@ void startShell()
 
 }
 
+// returns a printable name for the state of a task
+static char* taskStateName(TCB *task)
+{
+    if (task == taskCurrent)
+        return "running";
+    switch (task->state)
+    {
+        case STATE_READY:
+            return "ready";
+        case STATE_DELAYED:
+            return "delayed";
+        case STATE_BLOCKED:
+            return "blocked";
+        default:
+            return "stopped";
+    }
+}
+
+// prints part / whole as a percentage with one decimal
+static void printPermille(uint32_t part, uint32_t whole)
+{
+    char str[MAX_INT_STR_LENGTH + 1];
+    uint32_t permille = whole ? (uint64_t) part * 1000 / whole : 0;
+
+    putsUart0(integerToAlphabet(permille / 10, str));
+    putsUart0(".");
+    putsUart0(integerToAlphabet(permille % 10, str));
+}
+
+// prints the occupancy of a kernel object pool: used, peak, capacity and refused allocations
+static void printPool(const SLAB *pool)
+{
+    char str[MAX_INT_STR_LENGTH + 1];
+
+    putsUart0((char *) pool->name);
+    putsUart0("\t");
+    putsUart0(integerToAlphabet(pool->size, str));
+    putsUart0("\t");
+    putsUart0(integerToAlphabet(pool->used, str));
+    putsUart0("\t");
+    putsUart0(integerToAlphabet(pool->peak, str));
+    putsUart0("\t");
+    putsUart0(integerToAlphabet(pool->capacity, str));
+    putsUart0("\t");
+    putsUart0(integerToAlphabet(pool->failures, str));
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+}
+
+// prints one line per thread in the task table
 void ps()
 {
-    putsUart0("ps called.\n\r");
+    uint8_t i;
+    char str[MAX_INT_STR_LENGTH + 1];
+    const CPU_SNAPSHOT *snapshot = getCpuSnapshot();
+
+    putsUart0("PID\tNAME\t\tPRIO\tSTATE\tMISSES\tSTACK\t\tCPU %\n\r");
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state == STATE_INVALID)
+            continue;
+
+        putsUart0(integerToAlphabet(tcb[i].pid, str));
+        putsUart0("\t");
+        putsUart0(tcb[i].name);
+        putsUart0("\t\t");
+        putsUart0(integerToAlphabet(tcb[i].priority, str));
+        putsUart0("\t");
+        putsUart0(taskStateName(&tcb[i]));
+        putsUart0("\t");
+        putsUart0(tcb[i].relDeadline ? integerToAlphabet(tcb[i].deadlineMisses, str) : "-");
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(stackHighWater(&tcb[i]), str));
+        putsUart0("/");
+        putsUart0(integerToAlphabet(tcb[i].stackSize, str));
+        putsUart0("\t\t");
+        printPermille(snapshot->pid[i] == tcb[i].pid ? snapshot->cycles[i] : 0, snapshot->totalCycles);
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+
+    for (i = 0; i < admittedCount; i++)
+    {
+        putsUart0("Admitted pid ");
+        putsUart0(integerToAlphabet(admitted[i].pid, str));
+        putsUart0(", response time ");
+        putsUart0(integerToAlphabet(admitted[i].response, str));
+        putsUart0(" us of ");
+        putsUart0(integerToAlphabet(admitted[i].deadline, str));
+        putsUart0(" us\n\r");
+    }
+
+    putsUart0("POOL\tSIZE\tUSED\tPEAK\tTOTAL\tFULL\n\r");
+    printPool(&taskPool);
+
+    putsUart0("Interrupt handlers: ");
+    printPermille(snapshot->isrCycles, snapshot->totalCycles);
+    putsUart0(" %\n\r");
+
+    putsUart0("Tickless idle: ");
+    putsUart0(getTickless() ? "on" : "off");
+    putsUart0(", avoided wakeups: ");
+    putsUart0(integerToAlphabet(idleStats.avoidedWakeups, str));
+    putsUart0(", sleep time: ");
+    putsUart0(integerToAlphabet(idleStats.sleepCycles / (SYSTEM_CLOCK_HZ / 1000), str));
+    putsUart0(" ms\n\r");
+
+    putsUart0("MPU isolation: ");
+    putsUart0(getMpuIsolation() ? "on" : "off");
+    putsUart0(", windows: hits ");
+    putsUart0(integerToAlphabet(mpuCacheStats.hits, str));
+    putsUart0(", pinned ");
+    putsUart0(integerToAlphabet(mpuCacheStats.loads, str));
+    putsUart0(", misses ");
+    putsUart0(integerToAlphabet(mpuCacheStats.misses, str));
+    putsUart0(", evictions ");
+    putsUart0(integerToAlphabet(mpuCacheStats.evictions, str));
+    putsUart0(", violations ");
+    putsUart0(integerToAlphabet(mpuCacheStats.violations, str));
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
 }
 
+// prints the state and statistics of every kernel IPC object
 void ipcs()
 {
-    putsUart0("ipcs called.\n\r");
+    uint8_t i, count;
+    char str[MAX_INT_STR_LENGTH + 1];
+    TCB *waiter;
+
+    putsUart0("MUTEX\t\tTYPE\tOWNER\tWAITERS\tBOOSTS\tMAX BLOCK (us)\n\r");
+    for (i = 0; i < MAX_MUTEXES; i++)
+    {
+        if (!mutexes[i].valid)
+            continue;
+
+        count = 0;
+        for (waiter = mutexes[i].waiters; waiter != 0; waiter = waiter->waitNext)
+            count++;
+
+        putsUart0(mutexes[i].name);
+        putsUart0("\t\t");
+        putsUart0(mutexes[i].protocol == MUTEX_CEILING ? "pcp" : "pi");
+        putsUart0("\t");
+        putsUart0(mutexes[i].owner ? integerToAlphabet(mutexes[i].owner->pid, str) : "-");
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(count, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(mutexes[i].boosts, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(mutexes[i].maxBlockCycles / (SYSTEM_CLOCK_HZ / 1000000), str));
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+    putsUart0("SEMAPHORE\tCOUNT\tWAITERS\tTOP\tPOSTS\tWAITS\tTIMEOUTS\n\r");
+    for (i = 0; i < MAX_SEMAPHORES; i++)
+    {
+        if (!semaphores[i].valid)
+            continue;
+
+        count = 0;
+        for (waiter = semaphores[i].waiters; waiter != 0; waiter = waiter->waitNext)
+            count++;
+
+        putsUart0(semaphores[i].name);
+        putsUart0("\t\t");
+        putsUart0(integerToAlphabet(semaphores[i].count, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(count, str));
+        putsUart0("\t");
+        putsUart0(semaphores[i].waiters ? integerToAlphabet(semaphores[i].waiters->pid, str) : "-");
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(semaphores[i].posts, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(semaphores[i].waits, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(semaphores[i].timeouts, str));
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+
+    putsUart0("QUEUE\t\tMSGS\tDEPTH\tSENDERS\tRCVRS\tSENT\n\r");
+    for (i = 0; i < MAX_QUEUES; i++)
+    {
+        if (!queues[i].valid)
+            continue;
+
+        putsUart0(queues[i].name);
+        putsUart0("\t\t");
+        putsUart0(integerToAlphabet(queues[i].count, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(queues[i].depth, str));
+        putsUart0("\t");
+        count = 0;
+        for (waiter = queues[i].senders; waiter != 0; waiter = waiter->waitNext)
+            count++;
+        putsUart0(integerToAlphabet(count, str));
+        putsUart0("\t");
+        count = 0;
+        for (waiter = queues[i].receivers; waiter != 0; waiter = waiter->waitNext)
+            count++;
+        putsUart0(integerToAlphabet(count, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(queues[i].sent, str));
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+    putsUart0("Free message blocks: ");
+    putsUart0(integerToAlphabet(freeMessageBlocks(), str));
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    putsUart0("Free heap: ");
+    putsUart0(integerToAlphabet(heapFreeBytes(), str));
+    putsUart0(" bytes");
+    putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+
+    putsUart0("EVENTS\t\tFLAGS\t\tSETS\tWAKEUPS\n\r");
+    for (i = 0; i < MAX_EVENT_GROUPS; i++)
+    {
+        if (!eventGroups[i].valid)
+            continue;
+
+        putsUart0(eventGroups[i].name);
+        putsUart0("\t\t");
+        printHexWord(eventGroups[i].flags);
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(eventGroups[i].sets, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(eventGroups[i].wakeups, str));
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+
+        // one line per pending waiter with what it waits for
+        for (waiter = eventGroups[i].waiters; waiter != 0; waiter = waiter->waitNext)
+        {
+            putsUart0("  pid ");
+            putsUart0(integerToAlphabet(waiter->pid, str));
+            putsUart0(((EVENT_WAIT *) waiter->waitData)->options & EVENT_ALL ? " all of " : " any of ");
+            printHexWord(((EVENT_WAIT *) waiter->waitData)->mask);
+            putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+        }
+    }
+
+    putsUart0("TIMER\t\tSTATE\tPERIOD\tFIRES\tOVERRUNS\n\r");
+    for (i = 0; i < MAX_TIMERS; i++)
+    {
+        if (!timers[i].valid)
+            continue;
+
+        putsUart0(timers[i].name);
+        putsUart0("\t\t");
+        putsUart0(timers[i].node.slot != TIMER_IDLE ? "armed" : "idle");
+        putsUart0("\t");
+        putsUart0(timers[i].period ? integerToAlphabet(timers[i].period, str) : "-");
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(timers[i].fires, str));
+        putsUart0("\t");
+        putsUart0(integerToAlphabet(timers[i].overruns, str));
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+
+    putsUart0("SHMEM\t\tSIZE\tATTACHED (pid mode)\tADDRESS\n\r");
+    for (i = 0; i < MAX_SHARED_MEMORY; i++)
+    {
+        if (!segments[i].valid)
+            continue;
+
+        putsUart0(segments[i].name);
+        putsUart0("\t\t");
+        putsUart0(integerToAlphabet(segments[i].size, str));
+        putsUart0("\t");
+        for (count = 0; count < segments[i].attachments; count++)
+        {
+            putsUart0(integerToAlphabet(segments[i].pid[count], str));
+            putsUart0(segments[i].writable[count] ? " rw " : " ro ");
+        }
+        putsUart0("\t");
+        printHexWord((uint32_t) segments[i].base);
+        putsUart0(CARRIAGE_RETURN_AND_NEWLINE);
+    }
+
+    putsUart0("POOL\tSIZE\tUSED\tPEAK\tTOTAL\tFULL\n\r");
+    printPool(&mutexPool);
+    printPool(&semaphorePool);
+    printPool(&queuePool);
+    printPool(&eventGroupPool);
+    printPool(&timerPool);
+    printPool(&segmentPool);
+
+    putsUart0("Priority inheritance: ");
+    putsUart0(getPriorityInheritance() ? "on\n\r" : "off\n\r");
 }
 
+// ends a process and returns its stack, heap blocks, mutexes and messages to the kernel
 void kill(uint32_t pid)
 {
     char pidStr[MAX_INT_STR_LENGTH + 1];
+
+    if (!killThread(pid))
+    {
+        putsUart0("Invalid pid\n\r");
+        return;
+    }
     putsUart0("Process #");
     putsUart0(integerToAlphabet(pid, pidStr));
     putsUart0(" killed.\n\r");
 }
 
+// kills every process with the given name
 void pkill(const char proc_name[])
 {
+    TCB *found[MAX_TASKS];
+    uint8_t i, n, count = 0;
+
+    n = findTasksByName(proc_name, found);
+    for (i = 0; i < n; i++)
+        if (killThread(found[i]->pid))
+            count++;
+
+    if (count == 0)
+    {
+        putsUart0("No such process\n\r");
+        return;
+    }
     putsUart0((char*)proc_name);
     putsUart0(" killed.\n\r");
 }
 
 void pi(bool on)
 {
+    setPriorityInheritance(on);
     on ? putsUart0("pi ON.\n\r") : putsUart0("pi OFF.\n\r");
 }
 
 void preempt(bool on)
 {
+    setPreemption(on);
     on ? putsUart0("preempt ON.\n\r") : putsUart0("preempt OFF.\n\r");
 }
 
-void sched(bool prio_on)
+// with isolation on, user programs reach only their own SRAM subregions and declared windows
+void mpu(bool on)
 {
-    prio_on ? putsUart0("sched prio.\n\r") : putsUart0("sched rr.\n\r");
+    setMpuIsolation(on);
+    on ? putsUart0("mpu ON.\n\r") : putsUart0("mpu OFF.\n\r");
+}
+
+// changes the kernel tick rate (Hz)
+void tick(uint32_t hz)
+{
+    char str[MAX_INT_STR_LENGTH + 1];
+
+    if (!setTickRate(hz))
+    {
+        putsUart0("Tick rate out of range\n\r");
+        return;
+    }
+    putsUart0("Tick rate ");
+    putsUart0(integerToAlphabet(hz, str));
+    putsUart0(" Hz\n\r");
+}
+
+// changes the round robin time slice (ticks) of a process
+void quantum(uint32_t pid, uint32_t ticks)
+{
+    if (ticks > 0xFFFF || !setThreadQuantum(pid, ticks))
+        putsUart0("Invalid pid or quantum\n\r");
+}
+
+void sched(schedMode mode)
+{
+    setSchedulerMode(mode);
+    if (mode == SCHED_PRIO)
+        putsUart0("sched prio.\n\r");
+    else if (mode == SCHED_RR)
+        putsUart0("sched rr.\n\r");
+    else
+        putsUart0("sched edf.\n\r");
 }
 
+// prints the pids of every process with the given name
 void pidof(const char proc_name[])
 {
-    putsUart0((char*)proc_name);
-    putsUart0(" launched.\n\r");
+    char pidStr[MAX_INT_STR_LENGTH + 1];
+    TCB *found[MAX_TASKS];
+    uint8_t i, n;
+
+    n = findTasksByName(proc_name, found);
+    if (n == 0)
+    {
+        putsUart0("No such process\n\r");
+        return;
+    }
+    for (i = 0; i < n; i++)
+    {
+        putsUart0(integerToAlphabet(found[i]->pid, pidStr));
+        putsUart0(i + 1 < n ? " " : "\n\r");
+    }
 }
 
+// starts a built-in program, periodic programs only if the task set stays schedulable
 void run(const char proc_name[])
 {
-    ledState(RED, ON);
+    const PROGRAM *program = findProgram(proc_name);
+    uint32_t deadlineMs, pid;
+
+    if (program == 0)
+    {
+        putsUart0("Unknown program\n\r");
+        return;
+    }
+
+    if (program->periodMs == 0)
+    {
+        if (createUserThread(program->entry, program->name, program->priority, program->stackBytes,
+                                 program->windowBase, program->windowSize) == 0)
+            putsUart0("Out of resources\n\r");
+        return;
+    }
+
+    deadlineMs = program->deadlineMs ? program->deadlineMs : program->periodMs;
+    if (!admissionTest(program->priority, program->wcetUs, program->periodMs * 1000, deadlineMs * 1000))
+    {
+        putsUart0("Rejected: task set would be unschedulable\n\r");
+        return;
+    }
+
+    pid = createUserThread(program->entry, program->name, program->priority, program->stackBytes,
+                           program->windowBase, program->windowSize);
+    if (pid == 0)
+    {
+        putsUart0("Out of resources\n\r");
+        return;
+    }
+    setThreadDeadline(pid, program->periodMs, deadlineMs);
+    admissionCommit(pid);
 }
 
 void reboot()
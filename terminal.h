@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "kernel.h"
 
 //-----------------------------------------------------------------------------
 // RTOS Shell Variables/Macro/Structures/Functions
@@ -27,6 +28,7 @@ bool stringCompare(const char *str1, const char *str2);
 int32_t getFieldInteger(USER_DATA *data, uint8_t fieldNumber);
 uint32_t hexStrToInt(const char hex[]);
 void printHex(uint32_t);
+void printHexWord(uint32_t);
 char* integerToAlphabet(uint32_t decInt, char* outStr);
 bool isCommand(USER_DATA *data, const char strCommand[], uint8_t minArguments);
 
@@ -38,7 +40,10 @@ void kill(uint32_t pid);
 void pkill(const char proc_name[]);
 void pi(bool on);
 void preempt(bool on);
-void sched(bool prio_on);
+void mpu(bool on);
+void tick(uint32_t hz);
+void quantum(uint32_t pid, uint32_t ticks);
+void sched(schedMode mode);
 void pidof(const char proc_name[]);
 void run(const char proc_name[]);
 void reboot(void);
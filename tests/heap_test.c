@@ -0,0 +1,173 @@
+/*
+ *      Filename: heap_test.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Host randomized test and benchmark of the heap search (heap.c)
+//
+// heapFindRun() is compared with the subregion-at-a-time reference in
+// heapref.c on random free maps, request sizes and flags, and every block it
+// returns is checked against the placement rules directly: all subregions
+// free, inside the heap, no MPU region straddled unless allowed, large enough
+// for the request and, for aligned blocks, a power of two aligned by address. A fixed set of inputs is then timed through both.
+// The TI intrinsics map to their gcc equivalents.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#define _norm(x)                ((x) ? __builtin_clz(x) : 32)
+#define _disable_interrupts()   0
+#define _restore_interrupts(x)  ((void) (x))
+#define _set_interrupt_priority(x) 0
+#define __asm(x)
+
+#include "../heap.c"
+#include "../heapref.c"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#define CHECKS                  2000000UL
+#define TIMED_CALLS             4000000UL
+#define TIMED_INPUTS            4096
+
+static uint64_t timedMap[TIMED_INPUTS];
+static uint32_t timedSize[TIMED_INPUTS];
+static uint8_t timedFlags[TIMED_INPUTS];
+
+TCB *taskCurrent;
+
+//-----------------------------------------------------------------------------
+// Kernel stubs
+//-----------------------------------------------------------------------------
+
+uint64_t createNoSramAcccessMask(void)
+{
+    return 0;
+}
+
+void applySramRegionTable(SRAM_REGION_TABLE *table, uint64_t srd)
+{
+    (void) table;
+    (void) srd;
+}
+
+bool getMpuIsolation(void)
+{
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: blockAddress()
+* address a block at subregion first has on the target
+*/
+static uint32_t blockAddress(uint8_t first)
+{
+    if (first < HEAP_SMALL_SUBREGIONS)
+        return HEAP_BASE + first * HEAP_SMALL_SIZE;
+    return HEAP_BASE + HEAP_SMALL_SUBREGIONS * HEAP_SMALL_SIZE + (first - HEAP_SMALL_SUBREGIONS) * HEAP_LARGE_SIZE;
+}
+
+/*
+* Function: checkBlock()
+* returns a description of the first placement rule a found block breaks, 0 if none
+*/
+static const char *checkBlock(uint64_t freeMap, uint32_t size, uint8_t flags, uint8_t first, uint8_t count)
+{
+    uint32_t bytes = 0;
+    uint8_t i;
+
+    if (count == 0 || first + count > HEAP_SUBREGIONS)
+        return "outside the heap";
+    for (i = first; i < first + count; i++)
+    {
+        if (!((freeMap >> i) & 1))
+            return "takes a used subregion";
+        bytes += i < HEAP_SMALL_SUBREGIONS ? HEAP_SMALL_SIZE : HEAP_LARGE_SIZE;
+    }
+    if (bytes < size)
+        return "too small";
+    if (!(flags & HEAP_SPAN_REGIONS) && first / HEAP_REGION_SUBREGIONS != (first + count - 1) / HEAP_REGION_SUBREGIONS)
+        return "straddles an MPU region";
+    if ((flags & HEAP_ALIGNED) && ((bytes & (bytes - 1)) != 0 || blockAddress(first) % bytes != 0))
+        return "cannot be covered by one MPU region";
+    return 0;
+}
+
+static double nanoseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+int main(void)
+{
+    uint32_t seed = 1, size, k;
+    uint32_t mismatches = 0, broken = 0;
+    uint64_t freeMap;
+    uint8_t flags, fast, naive, fastCount = 0, naiveCount = 0;
+    const char *problem;
+    double start, fastTime, naiveTime;
+    volatile uint8_t sink;
+
+    for (k = 0; k < CHECKS; k++)
+    {
+        freeMap = randomFreeMap(&seed);
+        size = randomHeapSize(&seed);
+        flags = (seed >> 4) & (HEAP_SPAN_REGIONS | HEAP_ALIGNED);
+        fast = heapFindRun(freeMap, size, flags, &fastCount);
+        naive = naiveFindRun(freeMap, size, flags, &naiveCount);
+        if (fast != naive || (fast != HEAP_SUBREGIONS && fastCount != naiveCount))
+        {
+            if (mismatches++ == 0)
+                printf("map %010llx size %u flags %u: found %u+%u, reference %u+%u\n", (unsigned long long) freeMap,
+                       size, flags, fast, fastCount, naive, naiveCount);
+        }
+        if (fast != HEAP_SUBREGIONS && (problem = checkBlock(freeMap, size, flags, fast, fastCount)) != 0)
+        {
+            if (broken++ == 0)
+                printf("map %010llx size %u flags %u: block %u+%u at %08x %s\n", (unsigned long long) freeMap, size,
+                       flags, fast, fastCount, blockAddress(fast), problem);
+        }
+    }
+
+    // time both searches over the same pregenerated inputs
+    seed = 1;
+    for (k = 0; k < TIMED_INPUTS; k++)
+    {
+        timedMap[k] = randomFreeMap(&seed);
+        timedSize[k] = randomHeapSize(&seed);
+        timedFlags[k] = (seed >> 4) & (HEAP_SPAN_REGIONS | HEAP_ALIGNED);
+    }
+    start = nanoseconds();
+    for (k = 0; k < TIMED_CALLS; k++)
+        sink = heapFindRun(timedMap[k % TIMED_INPUTS], timedSize[k % TIMED_INPUTS], timedFlags[k % TIMED_INPUTS], &fastCount);
+    fastTime = nanoseconds() - start;
+    start = nanoseconds();
+    for (k = 0; k < TIMED_CALLS; k++)
+        sink = naiveFindRun(timedMap[k % TIMED_INPUTS], timedSize[k % TIMED_INPUTS], timedFlags[k % TIMED_INPUTS], &naiveCount);
+    naiveTime = nanoseconds() - start;
+    (void) sink;
+
+    printf("heap_test: %.1f ns per search (bitmap), %.1f ns (reference)\n", fastTime / TIMED_CALLS,
+           naiveTime / TIMED_CALLS);
+    if (mismatches || broken)
+    {
+        printf("heap_test: FAIL, %u mismatches, %u blocks breaking the rules in %lu checks\n", mismatches, broken,
+               CHECKS);
+        return 1;
+    }
+    printf("heap_test: pass, %lu checks\n", CHECKS);
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ *      Filename: ring_test.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// Host stress test of the SPSC ring (ring.c)
+//
+// A producer thread pushes a numbered byte stream while a consumer thread pops
+// it, both mixing single byte and span transfers of pseudo-random length, with
+// the free-running indices starting just below their 2^32 wrap. The consumer
+// fails the test on the first byte that is lost, repeated or out of order.
+// DMB maps to a full compiler and hardware barrier, so the orderings ring.c
+// relies on are the ones exercised here.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define DMB()                   __sync_synchronize()
+#include "../ring.c"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#define RING_SIZE               64
+#define STREAM_BYTES            50000000UL
+#define MAX_SPAN                (RING_SIZE + RING_SIZE / 2)    // spans longer than the ring hit the full case
+
+static uint8_t buffer[RING_SIZE];
+static RING ring;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t nextRandom(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+/*
+* Function: producer()
+* pushes bytes 0, 1, 2, ... (mod 256) until STREAM_BYTES were accepted
+*/
+static void *producer(void *arg)
+{
+    uint32_t seed = 1;
+    uint32_t sent = 0, n, i, pushed;
+    uint8_t data[MAX_SPAN];
+
+    (void) arg;
+    while (sent < STREAM_BYTES)
+    {
+        if (nextRandom(&seed) & 1)
+            pushed = ringPush(&ring, (uint8_t) sent) ? 1 : 0;
+        else
+        {
+            n = nextRandom(&seed) % MAX_SPAN + 1;
+            if (n > STREAM_BYTES - sent)
+                n = STREAM_BYTES - sent;
+            for (i = 0; i < n; i++)
+                data[i] = (uint8_t) (sent + i);
+            pushed = ringPushSpan(&ring, data, n);
+        }
+        sent += pushed;
+        if (pushed == 0)
+            sched_yield();
+    }
+    return 0;
+}
+
+/*
+* Function: consumer()
+* pops the stream and checks every byte, returns the number of errors
+*/
+static void *consumer(void *arg)
+{
+    uint32_t seed = 2;
+    uint32_t received = 0, n, i, popped;
+    uint8_t data[MAX_SPAN];
+    uintptr_t errors = 0;
+
+    (void) arg;
+    while (received < STREAM_BYTES)
+    {
+        if (nextRandom(&seed) & 1)
+            popped = ringPop(&ring, data) ? 1 : 0;
+        else
+        {
+            n = nextRandom(&seed) % MAX_SPAN + 1;
+            popped = ringPopSpan(&ring, data, n);
+        }
+        for (i = 0; i < popped; i++)
+            if (data[i] != (uint8_t) (received + i) && errors++ == 0)
+                printf("byte %lu: got %u, expected %u\n", (unsigned long) (received + i), data[i],
+                       (uint8_t) (received + i));
+        received += popped;
+        if (ringCount(&ring) > RING_SIZE && errors++ == 0)
+            printf("count %lu exceeds the ring size\n", (unsigned long) ringCount(&ring));
+        if (popped == 0)
+            sched_yield();
+    }
+    return (void *) errors;
+}
+
+int main(void)
+{
+    pthread_t producerThread, consumerThread;
+    void *errors;
+
+    initRing(&ring, buffer, RING_SIZE);
+    ring.head = ring.tail = 0xFFFFF000;         // cross the index wrap early in the run
+
+    pthread_create(&consumerThread, 0, consumer, 0);
+    pthread_create(&producerThread, 0, producer, 0);
+    pthread_join(producerThread, 0);
+    pthread_join(consumerThread, &errors);
+
+    if (errors != 0 || ringCount(&ring) != 0)
+    {
+        printf("ring_test: FAIL (%lu errors)\n", (unsigned long) (uintptr_t) errors);
+        return 1;
+    }
+    printf("ring_test: pass, %lu bytes\n", STREAM_BYTES);
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ *      Filename: timer.c
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+// One-shot and periodic software timers
+//
+// Timers live in the kernel timing wheel, so starting, stopping and expiring
+// one is O(1) however many are armed. The tick interrupt only re-arms a
+// periodic timer and hands the timer number to the timer service task through
+// a lock-free ring; the callback runs in that task, never in the interrupt.
+// A timer that expires again before its callback ran is merged into the
+// pending call and counted as an overrun.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+#include "timer.h"
+#include "ring.h"
+#include "semaphore.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+SOFT_TIMER timers[MAX_TIMERS];
+SLAB timerPool = SLAB_INIT("timers", timers, SOFT_TIMER, arg);
+
+// numbers of the expired timers, pushed by the tick interrupt and popped by the service task
+static uint8_t expiredBuffer[TIMER_QUEUE_SIZE];
+static RING expired;
+static uint8_t expiredSemaphore = INVALID_SEMAPHORE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+/*
+* Function: timerExpired()
+* wheel expiry, runs in the tick interrupt: re-arms a periodic timer and queues its callback
+*/
+static void timerExpired(TIMER *node)
+{
+    SOFT_TIMER *t = node->owner;
+
+    if (t->period)
+        wheelInsert(node, node->expires + t->period);
+
+    if (t->queued)
+        t->overruns++;
+    else
+    {
+        t->queued = true;
+        ringPush(&expired, t - timers);
+        postSemaphore(expiredSemaphore);
+    }
+}
+
+/*
+* Function: timerService()
+* runs the callbacks of expired timers
+*/
+static void timerService(void)
+{
+    SOFT_TIMER *t;
+    uint8_t timer;
+
+    while (1)
+    {
+        waitSemaphore(expiredSemaphore, WAIT_FOREVER);
+        if (!ringPop(&expired, &timer))
+            continue;
+
+        t = &timers[timer];
+        t->queued = false;
+        t->fires++;
+        t->callback(t->arg);
+    }
+}
+
+/*
+* Function: initTimerService()
+* creates the timer service task, call after initRtos()
+*/
+void initTimerService(void)
+{
+    initRing(&expired, expiredBuffer, TIMER_QUEUE_SIZE);
+    expiredSemaphore = createSemaphore("timers", 0);
+    createThread(timerService, "timers", TIMER_SERVICE_PRIORITY, TIMER_SERVICE_STACK);
+}
+
+/*
+* Function: createTimer()
+* returns the handle of a new stopped timer, INVALID_TIMER if none is free
+*/
+uint8_t createTimer(const char name[], timerCallback callback, void *arg)
+{
+    uint8_t i, j;
+    SOFT_TIMER *object;
+    uint32_t irqState;
+
+    if (callback == 0)
+        return INVALID_TIMER;
+
+    irqState = _disable_interrupts();
+    object = slabAlloc(&timerPool);
+    if (object == 0)
+    {
+        _restore_interrupts(irqState);
+        return INVALID_TIMER;
+    }
+    i = slabIndex(&timerPool, object);
+
+    timers[i].valid = true;
+    timers[i].node.next = 0;
+    timers[i].node.prev = 0;
+    timers[i].node.slot = TIMER_IDLE;
+    timers[i].node.expire = timerExpired;
+    timers[i].node.owner = &timers[i];
+    timers[i].period = 0;
+    timers[i].callback = callback;
+    timers[i].arg = arg;
+    timers[i].queued = false;
+    timers[i].fires = 0;
+    timers[i].overruns = 0;
+    for (j = 0; j < MAX_TIMER_NAME_LENGTH && name[j] != 0; j++)
+        timers[i].name[j] = name[j];
+    timers[i].name[j] = 0;
+
+    _restore_interrupts(irqState);
+    return i;
+}
+
+/*
+* Function: startTimer()
+* (re)arms a timer to fire after delayMs, then every periodMs (0 for a one-shot timer)
+*/
+bool startTimer(uint8_t timer, uint32_t delayMs, uint32_t periodMs)
+{
+    SOFT_TIMER *t = &timers[timer];
+    uint32_t irqState;
+
+    if (timer >= MAX_TIMERS || !t->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    wheelRemove(&t->node);
+    t->period = msToTicks(periodMs);
+    wheelInsert(&t->node, kernelTicks + msToTicks(delayMs));
+    _restore_interrupts(irqState);
+    return true;
+}
+
+/*
+* Function: stopTimer()
+* disarms a timer, a callback that is already queued still runs
+*/
+bool stopTimer(uint8_t timer)
+{
+    SOFT_TIMER *t = &timers[timer];
+    uint32_t irqState;
+
+    if (timer >= MAX_TIMERS || !t->valid)
+        return false;
+
+    irqState = _disable_interrupts();
+    wheelRemove(&t->node);
+    _restore_interrupts(irqState);
+    return true;
+}
@@ -0,0 +1,49 @@
+/*
+ *      Filename: timer.h
+ *
+ *      Created on: Oct 17, 2025
+ *      Author: Abhishek Dhital
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel.h"
+#include "slab.h"
+
+//-----------------------------------------------------------------------------
+// Software Timer Variables/Macro/Structures/Functions
+//-----------------------------------------------------------------------------
+#define MAX_TIMER_NAME_LENGTH   15
+#define INVALID_TIMER           0xFF
+
+#define TIMER_SERVICE_PRIORITY  1           // callbacks run above every application task but the most urgent
+#define TIMER_SERVICE_STACK     512
+#define TIMER_QUEUE_SIZE        16          // expired timers waiting for the service task, power of two
+
+typedef void (*timerCallback)(void *arg);
+
+typedef struct _SOFT_TIMER
+{
+    bool valid;
+    TIMER node;                             // entry in the kernel timing wheel
+    uint32_t period;                        // re-arm interval in ticks, 0 for a one-shot timer
+    timerCallback callback;
+    void *arg;
+    volatile bool queued;                   // waiting for the service task to run the callback
+    char name[MAX_TIMER_NAME_LENGTH + 1];
+    uint32_t fires;                         // callbacks run
+    uint32_t overruns;                      // expiries merged into a callback that was still queued
+} SOFT_TIMER;
+
+extern SOFT_TIMER timers[MAX_TIMERS];
+extern SLAB timerPool;
+
+void initTimerService(void);
+uint8_t createTimer(const char name[], timerCallback callback, void *arg);
+bool startTimer(uint8_t timer, uint32_t delayMs, uint32_t periodMs);
+bool stopTimer(uint8_t timer);
+
+#endif
@@ -60,6 +60,9 @@ extern void usageFaultISR(void);
 extern void hardFaultISR(void);
 extern void mpuFaultISR(void);
 extern void pendSvISR(void);
+extern void svCallISR(void);
+extern void systickISR(void);
+extern void uart0Isr(void);
 
 //*****************************************************************************
 //
@@ -83,17 +86,17 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
-    IntDefaultHandler,                      // SVCall handler
+    svCallISR,                              // SVCall handler
     IntDefaultHandler,                      // Debug monitor handler
     0,                                      // Reserved
     pendSvISR,                              // The PendSV handler
-    IntDefaultHandler,                      // The SysTick handler
+    systickISR,                             // The SysTick handler
     IntDefaultHandler,                      // GPIO Port A
     IntDefaultHandler,                      // GPIO Port B
     IntDefaultHandler,                      // GPIO Port C
     IntDefaultHandler,                      // GPIO Port D
     IntDefaultHandler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
+    uart0Isr,                               // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
@@ -22,6 +22,10 @@
 #include <stdbool.h>
 #include "tm4c123gh6pm.h"
 #include "uart0.h"
+#include "ring.h"
+#include "semaphore.h"
+#include "eventflags.h"
+#include "kernel.h"
 
 // PortA masks
 #define UART_TX_MASK 2
@@ -31,7 +35,12 @@
 // Global variables
 //-----------------------------------------------------------------------------
 
-extern void yield(void);
+// received characters, filled by uart0Isr() and drained by getcUart0()
+static uint8_t rxBuffer[UART0_RX_BUFFER_SIZE];
+static RING rxRing;
+static uint8_t rxEvents = INVALID_EVENT_GROUP;
+
+#define RX_READY 1                                  // rxEvents flag: rxRing went from empty to non-empty
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -71,6 +80,44 @@ void initUart0()
                                                         // enable TX, RX, and module
 }
 
+// Receive through the interrupt into rxRing, called after initRtos() since it needs an event group
+void initUart0Rx()
+{
+    initRing(&rxRing, rxBuffer, UART0_RX_BUFFER_SIZE);
+    rxEvents = createEventGroup("uart0rx");
+    UART0_IFLS_R = UART_IFLS_RX4_8;                     // interrupt at half full, timeout catches the rest
+    UART0_IM_R = UART_IM_RXIM | UART_IM_RTIM;
+    NVIC_EN0_R = 1 << (INT_UART0 - 16);
+}
+
+// Moves received characters from the FIFO into rxRing, characters are dropped while it is full
+// only the reader empties the ring, so the reader is signalled once, when it was empty before
+void uart0Isr()
+{
+    uint8_t *span;
+    uint32_t n, i;
+    uint32_t start = DWT_CYCCNT_R;                  // handler time is reported apart from task time
+    bool wasEmpty = ringCount(&rxRing) == 0;
+
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC;
+    while (!(UART0_FR_R & UART_FR_RXFE))
+    {
+        n = ringWriteSpan(&rxRing, &span);
+        if (n == 0)
+        {
+            while (!(UART0_FR_R & UART_FR_RXFE))
+                (void) UART0_DR_R;
+            break;
+        }
+        for (i = 0; i < n && !(UART0_FR_R & UART_FR_RXFE); i++)
+            span[i] = UART0_DR_R & 0xFF;
+        ringCommitWrite(&rxRing, i);
+    }
+    if (wasEmpty && ringCount(&rxRing) != 0)
+        setEventFlags(rxEvents, RX_READY);
+    isrCycles += DWT_CYCCNT_R - start;
+}
+
 // Set baud rate as function of instruction cycle frequency
 void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc)
 {
@@ -96,16 +143,18 @@ void putsUart0(char* str)
 }
 
 // Blocking function that returns with serial data once the buffer is not empty
+// the flag may be left over from characters already read, so the ring is checked after every wake
 char getcUart0()
 {
-    while (UART0_FR_R & UART_FR_RXFE);
-//        yield();        // yield if uart0 rx fifo empty
+    uint8_t c = 0;
 
-    return UART0_DR_R & 0xFF;                        // get character from fifo
+    while (!ringPop(&rxRing, &c))
+        waitEventFlags(rxEvents, RX_READY, EVENT_ANY | EVENT_CLEAR, WAIT_FOREVER);
+    return c;
 }
 
 // Returns the status of the receive buffer
 bool kbhitUart0()
 {
-    return !(UART0_FR_R & UART_FR_RXFE);
+    return ringCount(&rxRing) != 0;
 }
@@ -26,16 +26,19 @@
 #define CARRIAGE_RETURN_AND_NEWLINE "\n\r"
 #define PRINT_NEWLINE putsUart0(CARRIAGE_RETURN_AND_NEWLINE)
 #define MAX_INT_STR_LENGTH 10
+#define UART0_RX_BUFFER_SIZE 64     // power of two
 
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
 void initUart0();
+void initUart0Rx();
 void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc);
 void putcUart0(char c);
 void putsUart0(char* str);
 char getcUart0();
+void uart0Isr();
 bool kbhitUart0();
 
 #endif